@@ -0,0 +1,20 @@
+#pragma once
+
+#include <atomic>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Calls of the global operator new in all threads.
+//! Grows only in executables that link GeneticAlgorithmImpl/AllocationCounter.cpp: the benchmark, the tests
+//! and genetic_algorithm built with GA_COUNT_ALLOCATIONS; elsewhere it stays 0 and costs nothing.
+inline std::atomic<uint64_t> allocation_counter{0};
+
+inline uint64_t AllocationCount()
+{
+	return allocation_counter.load(std::memory_order_relaxed);
+}
+
+} // GeneticAlgorithm
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "stable.h"
+#include "IStateSink.h"
+
+namespace GA
+{
+
+//! Hands generations to another sink on a background thread.
+//! Generations are copied into a fixed set of buffers (two by default, i.e. double buffering),
+//! Consume blocks while all of them wait for the writer, so memory use doesn't grow with the run.
+template <typename Genotype, typename ScoreValue>
+class AsyncStateSink final : public IStateSink<Genotype, ScoreValue>
+{
+	struct Buffer
+	{
+		size_t iteration_ = 0;
+		State<Genotype, ScoreValue> state_;
+	};
+
+public:
+
+	explicit AsyncStateSink(const IStateSinkPtr<Genotype, ScoreValue>& sink, const size_t buffer_count = 2)
+			: sink_(sink)
+			, buffers_(buffer_count)
+	{
+		if (!sink)
+		{
+			throw std::runtime_error("Empty state sink");
+		}
+		if (buffer_count == 0)
+		{
+			throw std::runtime_error("Async state sink needs at least one buffer");
+		}
+
+		for (auto& buffer : buffers_)
+		{
+			free_buffers_.push_back(&buffer);
+		}
+
+		writer_ = std::thread([this]() { WriterLoop(); });
+	}
+
+	AsyncStateSink(const AsyncStateSink&) = delete;
+	AsyncStateSink& operator=(const AsyncStateSink&) = delete;
+
+	void Consume(const size_t iteration, const State<Genotype, ScoreValue>& state) override
+	{
+		Buffer* buffer;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			free_condition_.wait(lock, [this]() { return !free_buffers_.empty() || error_; });
+			RethrowError();
+
+			buffer = free_buffers_.front();
+			free_buffers_.pop_front();
+		}
+
+		buffer->iteration_ = iteration;
+		buffer->state_ = state;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			ready_buffers_.push_back(buffer);
+		}
+		ready_condition_.notify_one();
+	}
+
+	void Finish() override
+	{
+		Stop();
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		RethrowError();
+		sink_->Finish();
+	}
+
+	~AsyncStateSink() override
+	{
+		Stop();
+	}
+
+private:
+
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		ready_condition_.notify_one();
+
+		if (writer_.joinable())
+		{
+			writer_.join();
+		}
+	}
+
+	void WriterLoop()
+	{
+		while (true)
+		{
+			Buffer* buffer;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				ready_condition_.wait(lock, [this]() { return stop_ || !ready_buffers_.empty(); });
+				if (ready_buffers_.empty())
+				{
+					return;
+				}
+
+				buffer = ready_buffers_.front();
+				ready_buffers_.pop_front();
+			}
+
+			try
+			{
+				if (!error_)
+				{
+					sink_->Consume(buffer->iteration_, buffer->state_);
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				error_ = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				free_buffers_.push_back(buffer);
+			}
+			free_condition_.notify_one();
+		}
+	}
+
+	void RethrowError()
+	{
+		if (error_)
+		{
+			std::rethrow_exception(std::exchange(error_, nullptr));
+		}
+	}
+
+	IStateSinkPtr<Genotype, ScoreValue> sink_;
+	std::vector<Buffer> buffers_;
+
+	std::mutex mutex_;
+	std::condition_variable free_condition_;
+	std::condition_variable ready_condition_;
+	std::deque<Buffer*> free_buffers_;
+	std::deque<Buffer*> ready_buffers_;
+	bool stop_ = false;
+	std::exception_ptr error_;
+
+	std::thread writer_;
+};
+
+} // GeneticAlgorithm
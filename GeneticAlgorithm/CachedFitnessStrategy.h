@@ -0,0 +1,162 @@
+#pragma once
+
+#include "stable.h"
+#include "FitnessCache.h"
+#include "IGeneticAlgorithmStrategy.h"
+#include "ThreadScratch.h"
+
+namespace GA
+{
+
+//! Looks every genotype up in a FitnessCache before the fitness function of the wrapped strategy runs,
+//! the other operators are passed through. The wrapped fitness function must be deterministic.
+template <typename Genotype, typename Value>
+class CachedFitnessStrategy final : public IGeneticAlgorithmStrategy<Genotype, Value>
+{
+	using Population = std::vector<Genotype>;
+	using ScorePopulation = std::vector<Value>;
+
+public:
+
+	CachedFitnessStrategy(
+			const IGeneticAlgorithmStrategyPtr<Genotype, Value>& strategy,
+			const FitnessCachePtr<Genotype, Value>& cache)
+			: strategy_(strategy)
+			, cache_(cache)
+	{
+		if (!strategy_)
+		{
+			throw std::runtime_error("Empty strategy");
+		}
+		if (!cache_)
+		{
+			throw std::runtime_error("Empty fitness cache");
+		}
+	}
+
+	Population CreateStartPopulation(RandomGenerator& generator) const override
+	{
+		return strategy_->CreateStartPopulation(generator);
+	}
+
+	void CreateStartGenotypes(RandomGenerator& generator, Genotype* genotypes, const size_t count) const override
+	{
+		strategy_->CreateStartGenotypes(generator, genotypes, count);
+	}
+
+	Genotype Mutation(
+			const Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const override
+	{
+		return strategy_->Mutation(genotype, iteration_count, generator);
+	}
+
+	Genotype Crossingover(
+			const Genotype& first_parent, const Value first_score,
+			const Genotype& second_parent, const Value second_score,
+			RandomGenerator& generator) const override
+	{
+		return strategy_->Crossingover(first_parent, first_score, second_parent, second_score, generator);
+	}
+
+	void MutationInPlace(
+			Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const override
+	{
+		strategy_->MutationInPlace(genotype, iteration_count, generator);
+	}
+
+	void CrossingoverInto(
+			const Genotype& first_parent, const Value first_score,
+			const Genotype& second_parent, const Value second_score,
+			Genotype& child,
+			RandomGenerator& generator) const override
+	{
+		strategy_->CrossingoverInto(first_parent, first_score, second_parent, second_score, child, generator);
+	}
+
+	Value FitnessFunction(const Genotype& genotype) const override
+	{
+		Value value;
+		if (!cache_->Find(genotype, value))
+		{
+			value = strategy_->FitnessFunction(genotype);
+			cache_->Insert(genotype, value);
+		}
+		return value;
+	}
+
+	//! The misses go to the wrapped strategy as one batch, gathered in buffers of the calling thread.
+	void FitnessFunctionBatch(const Genotype* genotypes, const size_t count, Value* scores) const override
+	{
+		ThreadScratch<Scratch> scratch;
+		auto& missed = scratch->missed_;
+		missed.clear();
+		for (size_t index = 0; index < count; ++index)
+		{
+			if (!cache_->Find(genotypes[index], scores[index]))
+			{
+				missed.push_back(index);
+			}
+		}
+		if (missed.empty())
+		{
+			return;
+		}
+
+		auto& missed_genotypes = scratch->missed_genotypes_;
+		auto& missed_scores = scratch->missed_scores_;
+		missed_genotypes.resize(missed.size());
+		missed_scores.resize(missed.size());
+		for (size_t position = 0; position < missed.size(); ++position)
+		{
+			missed_genotypes[position] = genotypes[missed[position]];
+		}
+
+		strategy_->FitnessFunctionBatch(missed_genotypes.data(), missed.size(), missed_scores.data());
+
+		for (size_t position = 0; position < missed.size(); ++position)
+		{
+			scores[missed[position]] = missed_scores[position];
+			cache_->Insert(missed_genotypes[position], missed_scores[position]);
+		}
+	}
+
+	//! Unchanged individuals would only be cache hits.
+	bool IsIncrementalFitness() const override
+	{
+		return true;
+	}
+
+	void EndGeneration() const override
+	{
+		strategy_->EndGeneration();
+	}
+
+	bool IsCorrectResult(
+			const Population& population,
+			const ScorePopulation& score_population,
+			const PopulationStatistics<Value>& previous_statistics,
+			const PopulationStatistics<Value>& statistics) const override
+	{
+		return strategy_->IsCorrectResult(population, score_population, previous_statistics, statistics);
+	}
+
+	~CachedFitnessStrategy() override = default;
+
+private:
+
+	struct Scratch
+	{
+		std::vector<size_t> missed_;
+		Population missed_genotypes_;
+		ScorePopulation missed_scores_;
+	};
+
+	IGeneticAlgorithmStrategyPtr<Genotype, Value> strategy_;
+	FitnessCachePtr<Genotype, Value> cache_;
+};
+
+} // GeneticAlgorithm
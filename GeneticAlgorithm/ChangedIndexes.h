@@ -0,0 +1,52 @@
+#pragma once
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Individuals changed during one generation.
+//! Mark may be called from several threads for different indexes, Collect is called by one thread after them.
+class ChangedIndexes
+{
+	using Index = size_t;
+	using Indexes = std::vector<Index>;
+
+public:
+
+	//! Keeps the marks when the population size is the same.
+	void Resize(const size_t population_size)
+	{
+		if (flags_.size() != population_size)
+		{
+			flags_.assign(population_size, 0);
+		}
+	}
+
+	void Mark(const Index index)
+	{
+		assert(index < flags_.size());
+		flags_[index] = 1;
+	}
+
+	//! Returns the marked indexes in ascending order and clears the marks.
+	const Indexes& Collect()
+	{
+		indexes_.resize(flags_.size());
+		size_t count = 0;
+		for (Index index = 0; index < flags_.size(); ++index)
+		{
+			indexes_[count] = index;
+			count += flags_[index];
+		}
+		indexes_.resize(count);
+		std::fill(flags_.begin(), flags_.end(), 0);
+		return indexes_;
+	}
+
+private:
+	std::vector<uint8_t> flags_;
+	Indexes indexes_;
+};
+
+} // GeneticAlgorithm
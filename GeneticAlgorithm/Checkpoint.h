@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "stable.h"
+#include "IStateSink.h"
+
+namespace GA
+{
+
+//! Checkpoint file: CheckpointFileHeader, then population_size_ genotypes and population_size_ scores.
+struct CheckpointFileHeader
+{
+	char magic_[8];
+	uint32_t version_;
+	uint32_t header_size_;
+	uint64_t genotype_size_;
+	uint64_t value_size_;
+	uint64_t population_size_;
+	uint64_t seed_;
+	uint64_t iteration_count_;
+	double mutation_part_;
+	double crossingover_part_;
+	//! Names of the fitness and selection functions of the run, padded with zeros.
+	char function_type_[24];
+	char selection_function_type_[24];
+	uint64_t reserved_[1];
+};
+
+static_assert(sizeof(CheckpointFileHeader) == 128, "Checkpoint header must stay 128 bytes");
+
+//! Everything a run needs to continue from the beginning of generation iteration_count_.
+//! Random streams are counter based, so the seed and the generation number restore them,
+//! and the statistics for the convergence check are computed again from the scores.
+template <typename Genotype, typename ScoreValue>
+struct Checkpoint
+{
+	uint64_t seed_ = 0;
+	double mutation_part_ = 0.0;
+	double crossingover_part_ = 0.0;
+	std::string function_type_;
+	std::string selection_function_type_;
+	size_t iteration_count_ = 0;
+	State<Genotype, ScoreValue> state_;
+};
+
+constexpr char checkpoint_file_magic[8] = {'G', 'A', 'C', 'K', 'P', 'T', '0', '1'};
+constexpr uint32_t checkpoint_file_version = 2;
+
+//! A name must leave room for the terminating zero of its header field.
+template <size_t Size>
+void WriteCheckpointName(char (&field)[Size], const std::string& name)
+{
+	if (name.size() >= Size)
+	{
+		throw std::runtime_error("Name is too long for a checkpoint: " + name);
+	}
+	std::memcpy(field, name.data(), name.size());
+}
+
+template <size_t Size>
+std::string ReadCheckpointName(const char (&field)[Size])
+{
+	return std::string(field, ::strnlen(field, Size));
+}
+
+//! Writes a temporary file, flushes it to the disk and puts it in place of the old checkpoint,
+//! so the file always holds a whole checkpoint, even when the process is killed while writing.
+template <typename Genotype, typename ScoreValue>
+void WriteCheckpoint(
+		const std::string& file_name,
+		const uint64_t seed,
+		const double mutation_part,
+		const double crossingover_part,
+		const std::string& function_type,
+		const std::string& selection_function_type,
+		const size_t iteration_count,
+		const State<Genotype, ScoreValue>& state)
+{
+	static_assert(std::is_trivially_copyable_v<Genotype> && std::is_trivially_copyable_v<ScoreValue>,
+			"Checkpoints keep raw bytes of genotypes and scores");
+
+	const size_t population_size = state.current_population_.size();
+	if (state.current_population_score_.size() != population_size)
+	{
+		throw std::runtime_error("Checkpoint population and scores differ in size");
+	}
+
+	CheckpointFileHeader header{};
+	std::memcpy(header.magic_, checkpoint_file_magic, sizeof(header.magic_));
+	header.version_ = checkpoint_file_version;
+	header.header_size_ = sizeof(CheckpointFileHeader);
+	header.genotype_size_ = sizeof(Genotype);
+	header.value_size_ = sizeof(ScoreValue);
+	header.population_size_ = population_size;
+	header.seed_ = seed;
+	header.iteration_count_ = iteration_count;
+	header.mutation_part_ = mutation_part;
+	header.crossingover_part_ = crossingover_part;
+	WriteCheckpointName(header.function_type_, function_type);
+	WriteCheckpointName(header.selection_function_type_, selection_function_type);
+
+	const std::string temporary_name = file_name + ".tmp";
+	std::FILE* file = std::fopen(temporary_name.c_str(), "wb");
+	if (!file)
+	{
+		throw std::runtime_error("Can't open checkpoint file: " + temporary_name);
+	}
+	const bool is_written = std::fwrite(&header, sizeof(header), 1, file) == 1
+			&& std::fwrite(state.current_population_.data(), sizeof(Genotype), population_size, file) == population_size
+			&& std::fwrite(state.current_population_score_.data(), sizeof(ScoreValue), population_size, file) == population_size
+			&& std::fflush(file) == 0
+			&& ::fsync(::fileno(file)) == 0;
+	if (std::fclose(file) != 0 || !is_written)
+	{
+		std::remove(temporary_name.c_str());
+		throw std::runtime_error("Can't write checkpoint file: " + temporary_name);
+	}
+	if (std::rename(temporary_name.c_str(), file_name.c_str()) != 0)
+	{
+		throw std::runtime_error("Can't replace checkpoint file: " + file_name);
+	}
+}
+
+inline bool IsCheckpointFile(const std::string& file_name)
+{
+	return ::access(file_name.c_str(), F_OK) == 0;
+}
+
+template <typename Genotype, typename ScoreValue>
+Checkpoint<Genotype, ScoreValue> ReadCheckpoint(const std::string& file_name)
+{
+	static_assert(std::is_trivially_copyable_v<Genotype> && std::is_trivially_copyable_v<ScoreValue>,
+			"Checkpoints keep raw bytes of genotypes and scores");
+
+	std::FILE* file = std::fopen(file_name.c_str(), "rb");
+	if (!file)
+	{
+		throw std::runtime_error("Can't open checkpoint file: " + file_name);
+	}
+
+	CheckpointFileHeader header{};
+	const bool is_header_read = std::fread(&header, sizeof(header), 1, file) == 1;
+	const bool is_valid = is_header_read
+			&& std::memcmp(header.magic_, checkpoint_file_magic, sizeof(header.magic_)) == 0
+			&& header.version_ == checkpoint_file_version
+			&& header.header_size_ == sizeof(CheckpointFileHeader)
+			&& header.genotype_size_ == sizeof(Genotype)
+			&& header.value_size_ == sizeof(ScoreValue)
+			&& header.population_size_ != 0;
+	if (!is_valid)
+	{
+		std::fclose(file);
+		throw std::runtime_error("Incompatible checkpoint file: " + file_name);
+	}
+
+	Checkpoint<Genotype, ScoreValue> checkpoint;
+	checkpoint.seed_ = header.seed_;
+	checkpoint.mutation_part_ = header.mutation_part_;
+	checkpoint.crossingover_part_ = header.crossingover_part_;
+	checkpoint.function_type_ = ReadCheckpointName(header.function_type_);
+	checkpoint.selection_function_type_ = ReadCheckpointName(header.selection_function_type_);
+	checkpoint.iteration_count_ = header.iteration_count_;
+
+	const size_t population_size = header.population_size_;
+	auto& state = checkpoint.state_;
+	state.current_population_.resize(population_size);
+	state.current_population_score_.resize(population_size);
+	const bool is_read = std::fread(state.current_population_.data(), sizeof(Genotype), population_size, file) == population_size
+			&& std::fread(state.current_population_score_.data(), sizeof(ScoreValue), population_size, file) == population_size
+			&& std::fgetc(file) == EOF;
+	std::fclose(file);
+	if (!is_read)
+	{
+		throw std::runtime_error("Truncated checkpoint file: " + file_name);
+	}
+	return checkpoint;
+}
+
+//! Writes every generation it gets as the checkpoint of a run, the file keeps only the last one.
+//! Put it behind an IntervalStateSink to choose how often, and behind an AsyncStateSink
+//! to write while the next generations are computed.
+template <typename Genotype, typename ScoreValue>
+class CheckpointSink final : public IStateSink<Genotype, ScoreValue>
+{
+public:
+
+	CheckpointSink(
+			const std::string& file_name,
+			const uint64_t seed,
+			const double mutation_part,
+			const double crossingover_part,
+			const std::string& function_type,
+			const std::string& selection_function_type)
+			: file_name_(file_name)
+			, seed_(seed)
+			, mutation_part_(mutation_part)
+			, crossingover_part_(crossingover_part)
+			, function_type_(function_type)
+			, selection_function_type_(selection_function_type)
+	{}
+
+	void Consume(const size_t iteration, const State<Genotype, ScoreValue>& state) override
+	{
+		WriteCheckpoint(
+				file_name_, seed_, mutation_part_, crossingover_part_,
+				function_type_, selection_function_type_, iteration, state);
+	}
+
+private:
+	std::string file_name_;
+	uint64_t seed_;
+	double mutation_part_;
+	double crossingover_part_;
+	std::string function_type_;
+	std::string selection_function_type_;
+};
+
+} // GeneticAlgorithm
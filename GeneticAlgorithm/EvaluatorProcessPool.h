@@ -0,0 +1,630 @@
+#pragma once
+
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "stable.h"
+#include "EvaluatorProtocol.h"
+
+namespace GA
+{
+
+struct EvaluatorPoolStatistics
+{
+	uint64_t request_count_ = 0;
+	uint64_t restart_count_ = 0;
+};
+
+//! Scores genotypes in worker processes started from command, each one talks EvaluatorProtocol
+//! over a Unix socket that is its standard input and output.
+//! Evaluate may be called from any number of threads: the genotypes are cut into requests of batch_size,
+//! which go into one queue, and an I/O thread keeps up to pipeline_depth requests in flight on every worker,
+//! so a worker has the next request as soon as it has answered one.
+//! A worker that dies or breaks the protocol is started again and its requests go back to the queue;
+//! a request that has been on max_attempt_count crashed workers fails its call, and when workers fail
+//! more often in a row than max_attempt_count times the process count, every call fails.
+class EvaluatorProcessPool
+{
+	//! Everything but items_ and results_ is guarded by mutex_.
+	struct Call
+	{
+		size_t remaining_count_ = 0;
+		std::exception_ptr error_;
+	};
+
+	struct Request
+	{
+		const unsigned char* items_;
+		unsigned char* results_;
+		size_t count_;
+		Call* call_;
+		size_t attempt_count_ = 0;
+	};
+
+	//! Only the I/O thread touches workers; in_flight_ holds the requests in the order they are sent,
+	//! requests before sent_count_ are sent whole, sent_bytes_ of the next one are sent.
+	struct Worker
+	{
+		pid_t pid_ = -1;
+		int socket_ = -1;
+		uint64_t answered_count_ = 0;
+		std::deque<Request> in_flight_;
+		size_t sent_count_ = 0;
+		size_t sent_bytes_ = 0;
+		std::vector<unsigned char> input_;
+	};
+
+public:
+
+	EvaluatorProcessPool(
+			const std::vector<std::string>& command,
+			const size_t process_count,
+			const size_t item_size,
+			const size_t result_size,
+			const size_t batch_size = 256,
+			const size_t pipeline_depth = 2,
+			const size_t max_attempt_count = 3)
+			: command_(command)
+			, item_size_(item_size)
+			, result_size_(result_size)
+			, batch_size_(batch_size)
+			, pipeline_depth_(pipeline_depth)
+			, max_attempt_count_(max_attempt_count)
+			, workers_(process_count)
+	{
+		if (command.empty())
+		{
+			throw std::runtime_error("Empty evaluator command");
+		}
+		if (process_count == 0 || batch_size == 0 || pipeline_depth == 0 || max_attempt_count == 0)
+		{
+			throw std::runtime_error("Evaluator process count, batch size, pipeline depth and attempts must be positive");
+		}
+		if (item_size == 0 || item_size > std::numeric_limits<uint32_t>::max()
+				|| result_size == 0 || result_size > std::numeric_limits<uint32_t>::max())
+		{
+			throw std::runtime_error("Incorrect evaluator element size");
+		}
+
+		if (::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0)
+		{
+			throw std::runtime_error("Can't create evaluator wake pipe");
+		}
+
+		try
+		{
+			for (auto& worker : workers_)
+			{
+				Start(worker);
+			}
+		}
+		catch (...)
+		{
+			Shutdown();
+			throw;
+		}
+
+		io_thread_ = std::thread([this]() { IoLoop(); });
+	}
+
+	EvaluatorProcessPool(const EvaluatorProcessPool&) = delete;
+	EvaluatorProcessPool& operator=(const EvaluatorProcessPool&) = delete;
+
+	~EvaluatorProcessPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			is_stopped_ = true;
+		}
+		Wake();
+		io_thread_.join();
+		Shutdown();
+	}
+
+	size_t ItemSize() const
+	{
+		return item_size_;
+	}
+
+	size_t ResultSize() const
+	{
+		return result_size_;
+	}
+
+	//! Scores count items of ItemSize bytes into count results of ResultSize bytes, blocks until all of them are back.
+	void Evaluate(const void* items, const size_t count, void* results)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		Call call;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (is_broken_)
+			{
+				throw std::runtime_error("Evaluator workers keep failing");
+			}
+
+			for (size_t begin = 0; begin < count; begin += batch_size_)
+			{
+				const size_t size = std::min(batch_size_, count - begin);
+				queue_.push_back(Request{
+						static_cast<const unsigned char*>(items) + begin * item_size_,
+						static_cast<unsigned char*>(results) + begin * result_size_,
+						size,
+						&call});
+				++call.remaining_count_;
+			}
+			statistics_.request_count_ += call.remaining_count_;
+		}
+		Wake();
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_condition_.wait(lock, [&call]() { return call.remaining_count_ == 0; });
+		if (call.error_)
+		{
+			std::rethrow_exception(call.error_);
+		}
+	}
+
+	EvaluatorPoolStatistics Statistics() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return statistics_;
+	}
+
+private:
+
+	//! The worker reports a failed exec through a close-on-exec pipe, which closes without data when exec succeeds.
+	void Start(Worker& worker)
+	{
+		std::vector<char*> arguments;
+		for (const auto& argument : command_)
+		{
+			arguments.push_back(const_cast<char*>(argument.c_str()));
+		}
+		arguments.push_back(nullptr);
+
+		int sockets[2];
+		if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+		{
+			throw std::runtime_error("Can't create evaluator socket");
+		}
+		int exec_pipe[2];
+		if (::pipe2(exec_pipe, O_CLOEXEC) != 0)
+		{
+			::close(sockets[0]);
+			::close(sockets[1]);
+			throw std::runtime_error("Can't create evaluator exec pipe");
+		}
+
+		const pid_t pid = ::fork();
+		if (pid < 0)
+		{
+			::close(sockets[0]);
+			::close(sockets[1]);
+			::close(exec_pipe[0]);
+			::close(exec_pipe[1]);
+			throw std::runtime_error("Can't fork evaluator worker");
+		}
+		if (pid == 0)
+		{
+			// Only async-signal-safe calls between fork and exec
+			::dup2(sockets[1], STDIN_FILENO);
+			::dup2(sockets[1], STDOUT_FILENO);
+			::execvp(arguments[0], arguments.data());
+			const int error = errno;
+			[[maybe_unused]] const ssize_t written = ::write(exec_pipe[1], &error, sizeof(error));
+			::_exit(127);
+		}
+
+		::close(sockets[1]);
+		::close(exec_pipe[1]);
+		int error = 0;
+		ssize_t read_size;
+		do
+		{
+			read_size = ::read(exec_pipe[0], &error, sizeof(error));
+		}
+		while (read_size < 0 && errno == EINTR);
+		::close(exec_pipe[0]);
+		if (read_size > 0)
+		{
+			::close(sockets[0]);
+			::waitpid(pid, nullptr, 0);
+			throw std::runtime_error("Can't start evaluator worker " + command_.front() + ": " + std::strerror(error));
+		}
+
+		::fcntl(sockets[0], F_SETFL, ::fcntl(sockets[0], F_GETFL) | O_NONBLOCK);
+		worker.pid_ = pid;
+		worker.socket_ = sockets[0];
+		worker.answered_count_ = 0;
+		worker.in_flight_.clear();
+		worker.sent_count_ = 0;
+		worker.sent_bytes_ = 0;
+		worker.input_.clear();
+	}
+
+	void Wake()
+	{
+		const char byte = 0;
+		[[maybe_unused]] const ssize_t written = ::write(wake_pipe_[1], &byte, 1);
+	}
+
+	void IoLoop()
+	{
+		std::vector<pollfd> descriptors;
+		while (true)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (is_stopped_)
+				{
+					return;
+				}
+				Dispatch();
+			}
+
+			descriptors.clear();
+			descriptors.push_back(pollfd{wake_pipe_[0], POLLIN, 0});
+			for (const auto& worker : workers_)
+			{
+				const bool is_sending = worker.sent_count_ < worker.in_flight_.size();
+				descriptors.push_back(pollfd{worker.socket_, static_cast<short>(POLLIN | (is_sending ? POLLOUT : 0)), 0});
+			}
+
+			if (::poll(descriptors.data(), descriptors.size(), -1) < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				Break(std::make_exception_ptr(std::runtime_error("Can't poll evaluator workers")));
+				return;
+			}
+
+			if (descriptors[0].revents != 0)
+			{
+				char bytes[64];
+				while (::read(wake_pipe_[0], bytes, sizeof(bytes)) > 0)
+				{}
+			}
+
+			for (size_t index = 0; index < workers_.size(); ++index)
+			{
+				const short events = descriptors[index + 1].revents;
+				if (events == 0)
+				{
+					continue;
+				}
+
+				Worker& worker = workers_[index];
+				const bool is_alive = ((events & POLLOUT) == 0 || Send(worker))
+						&& ((events & (POLLIN | POLLHUP | POLLERR)) == 0 || Receive(worker));
+				if (!is_alive)
+				{
+					Restart(worker);
+				}
+			}
+		}
+	}
+
+	//! Moves requests from the queue to the workers with the fewest requests in flight. Called under mutex_.
+	void Dispatch()
+	{
+		while (!queue_.empty() && !is_broken_)
+		{
+			Worker* target = nullptr;
+			for (auto& worker : workers_)
+			{
+				if (worker.pid_ > 0 && worker.in_flight_.size() < pipeline_depth_
+						&& (!target || worker.in_flight_.size() < target->in_flight_.size()))
+				{
+					target = &worker;
+				}
+			}
+			if (!target)
+			{
+				return;
+			}
+
+			target->in_flight_.push_back(queue_.front());
+			queue_.pop_front();
+		}
+	}
+
+	//! false when the worker is gone.
+	bool Send(Worker& worker)
+	{
+		while (worker.sent_count_ < worker.in_flight_.size())
+		{
+			const Request& request = worker.in_flight_[worker.sent_count_];
+			const EvaluatorFrameHeader header{
+					evaluator_frame_magic, static_cast<uint32_t>(item_size_), RequestId(worker, worker.sent_count_), request.count_};
+			const size_t payload_size = request.count_ * item_size_;
+
+			const unsigned char* data;
+			size_t size;
+			if (worker.sent_bytes_ < sizeof(header))
+			{
+				data = reinterpret_cast<const unsigned char*>(&header) + worker.sent_bytes_;
+				size = sizeof(header) - worker.sent_bytes_;
+			}
+			else
+			{
+				data = request.items_ + (worker.sent_bytes_ - sizeof(header));
+				size = sizeof(header) + payload_size - worker.sent_bytes_;
+			}
+
+			const ssize_t written = ::send(worker.socket_, data, size, MSG_NOSIGNAL);
+			if (written < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				return errno == EAGAIN || errno == EWOULDBLOCK;
+			}
+
+			worker.sent_bytes_ += static_cast<size_t>(written);
+			if (worker.sent_bytes_ == sizeof(header) + payload_size)
+			{
+				++worker.sent_count_;
+				worker.sent_bytes_ = 0;
+			}
+		}
+		return true;
+	}
+
+	//! Reads what the worker has written and completes the answered requests, false when the worker is gone
+	//! or has answered something it wasn't asked.
+	bool Receive(Worker& worker)
+	{
+		unsigned char buffer[65536];
+		bool is_closed = false;
+		while (!is_closed)
+		{
+			const ssize_t read_size = ::recv(worker.socket_, buffer, sizeof(buffer), 0);
+			if (read_size > 0)
+			{
+				worker.input_.insert(worker.input_.end(), buffer, buffer + read_size);
+				continue;
+			}
+			if (read_size < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (read_size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				break;
+			}
+			// Answers written before the worker closed its socket still count
+			is_closed = true;
+		}
+
+		size_t position = 0;
+		while (worker.input_.size() - position >= sizeof(EvaluatorFrameHeader))
+		{
+			EvaluatorFrameHeader header;
+			std::memcpy(&header, worker.input_.data() + position, sizeof(header));
+			if (worker.in_flight_.empty() || worker.sent_count_ == 0)
+			{
+				return false;
+			}
+
+			const Request& request = worker.in_flight_.front();
+			const bool is_expected = header.magic_ == evaluator_frame_magic
+					&& header.element_size_ == result_size_
+					&& header.id_ == RequestId(worker, 0)
+					&& header.count_ == request.count_;
+			if (!is_expected)
+			{
+				return false;
+			}
+
+			const size_t payload_size = request.count_ * result_size_;
+			if (worker.input_.size() - position < sizeof(header) + payload_size)
+			{
+				break;
+			}
+
+			std::memcpy(request.results_, worker.input_.data() + position + sizeof(header), payload_size);
+			position += sizeof(header) + payload_size;
+
+			Complete(request);
+			worker.in_flight_.pop_front();
+			--worker.sent_count_;
+			++worker.answered_count_;
+		}
+		worker.input_.erase(worker.input_.begin(), worker.input_.begin() + position);
+		return !is_closed;
+	}
+
+	//! Ids count the requests a worker process has got, so a response to an older request is caught.
+	static uint64_t RequestId(const Worker& worker, const size_t in_flight_position)
+	{
+		return worker.answered_count_ + in_flight_position;
+	}
+
+	//! An answered request ends a run of failed workers.
+	void Complete(const Request& request)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		consecutive_failure_count_ = 0;
+		if (--request.call_->remaining_count_ == 0)
+		{
+			done_condition_.notify_all();
+		}
+	}
+
+	//! Puts the requests of the worker back in the queue, or fails the ones that have crashed too many workers.
+	void Restart(Worker& worker)
+	{
+		Stop(worker);
+
+		std::vector<Request> failed;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++statistics_.restart_count_;
+			++consecutive_failure_count_;
+			if (consecutive_failure_count_ > max_attempt_count_ * workers_.size())
+			{
+				is_broken_ = true;
+			}
+
+			for (auto request = worker.in_flight_.rbegin(); request != worker.in_flight_.rend(); ++request)
+			{
+				if (++request->attempt_count_ >= max_attempt_count_ || is_broken_)
+				{
+					failed.push_back(*request);
+				}
+				else
+				{
+					queue_.push_front(*request);
+				}
+			}
+		}
+		worker.in_flight_.clear();
+
+		for (const auto& request : failed)
+		{
+			FailRequest(request, "Evaluator worker failed on a batch " + std::to_string(request.attempt_count_) + " times");
+		}
+
+		if (IsBroken())
+		{
+			Break(std::make_exception_ptr(std::runtime_error("Evaluator workers keep failing")));
+			return;
+		}
+
+		try
+		{
+			Start(worker);
+		}
+		catch (...)
+		{
+			Break(std::current_exception());
+		}
+	}
+
+	bool IsBroken() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return is_broken_;
+	}
+
+	void FailRequest(const Request& request, const std::string& message)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!request.call_->error_)
+		{
+			request.call_->error_ = std::make_exception_ptr(std::runtime_error(message));
+		}
+		if (--request.call_->remaining_count_ == 0)
+		{
+			done_condition_.notify_all();
+		}
+	}
+
+	//! Fails every waiting request, later calls fail at once.
+	void Break(const std::exception_ptr& error)
+	{
+		std::vector<Request> failed;
+		for (auto& worker : workers_)
+		{
+			failed.insert(failed.end(), worker.in_flight_.begin(), worker.in_flight_.end());
+			worker.in_flight_.clear();
+			worker.sent_count_ = 0;
+			worker.sent_bytes_ = 0;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		is_broken_ = true;
+		failed.insert(failed.end(), queue_.begin(), queue_.end());
+		queue_.clear();
+		for (const auto& request : failed)
+		{
+			if (!request.call_->error_)
+			{
+				request.call_->error_ = error;
+			}
+			--request.call_->remaining_count_;
+		}
+		done_condition_.notify_all();
+	}
+
+	static void Stop(Worker& worker)
+	{
+		if (worker.pid_ > 0)
+		{
+			::kill(worker.pid_, SIGKILL);
+			::waitpid(worker.pid_, nullptr, 0);
+			worker.pid_ = -1;
+		}
+		if (worker.socket_ >= 0)
+		{
+			::close(worker.socket_);
+			worker.socket_ = -1;
+		}
+	}
+
+	//! Closing the socket ends the input of a worker, which then exits by itself.
+	void Shutdown()
+	{
+		for (auto& worker : workers_)
+		{
+			if (worker.socket_ >= 0)
+			{
+				::close(worker.socket_);
+				worker.socket_ = -1;
+			}
+		}
+		for (auto& worker : workers_)
+		{
+			if (worker.pid_ > 0)
+			{
+				::waitpid(worker.pid_, nullptr, 0);
+				worker.pid_ = -1;
+			}
+		}
+		::close(wake_pipe_[0]);
+		::close(wake_pipe_[1]);
+	}
+
+	std::vector<std::string> command_;
+	size_t item_size_;
+	size_t result_size_;
+	size_t batch_size_;
+	size_t pipeline_depth_;
+	size_t max_attempt_count_;
+
+	std::vector<Worker> workers_;
+	int wake_pipe_[2] = {-1, -1};
+	std::thread io_thread_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable done_condition_;
+	std::deque<Request> queue_;
+	bool is_stopped_ = false;
+	bool is_broken_ = false;
+	size_t consecutive_failure_count_ = 0;
+	EvaluatorPoolStatistics statistics_;
+};
+
+using EvaluatorProcessPoolPtr = std::shared_ptr<EvaluatorProcessPool>;
+
+} // GeneticAlgorithm
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cerrno>
+
+#include <unistd.h>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Frames between an EvaluatorProcessPool and its workers, in both directions: the header, then count_ elements
+//! of element_size_ bytes. A request holds genotypes, its response the scores of those genotypes in the same order,
+//! under the same id_. Elements are raw bytes, so workers run on the same architecture as the pool.
+//! A worker reads requests from its standard input and writes responses to its standard output, one at a time,
+//! and exits when its input is closed.
+struct EvaluatorFrameHeader
+{
+	uint32_t magic_;
+	uint32_t element_size_;
+	uint64_t id_;
+	uint64_t count_;
+};
+
+static_assert(sizeof(EvaluatorFrameHeader) == 24, "Evaluator frame header must stay 24 bytes");
+
+//! "GAEV" in the bytes of a little endian number.
+constexpr uint32_t evaluator_frame_magic = 0x56454147;
+
+//! false when input is closed before the first byte, an error when it is closed in the middle.
+inline bool ReadFrameBytes(const int input, void* data, const size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	size_t read_size = 0;
+	while (read_size < size)
+	{
+		const ssize_t result = ::read(input, bytes + read_size, size - read_size);
+		if (result > 0)
+		{
+			read_size += static_cast<size_t>(result);
+			continue;
+		}
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (result == 0 && read_size == 0)
+		{
+			return false;
+		}
+		throw std::runtime_error("Evaluator frame is cut short");
+	}
+	return true;
+}
+
+inline void WriteFrameBytes(const int output, const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size != 0)
+	{
+		const ssize_t written = ::write(output, bytes, size);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw std::runtime_error("Can't write evaluator frame");
+		}
+		bytes += written;
+		size -= static_cast<size_t>(written);
+	}
+}
+
+//! The loop of a worker: scores every request with function(genotypes, count, scores) until input is closed.
+template <typename Genotype, typename Value, typename Function>
+void ServeEvaluatorRequests(const int input, const int output, Function&& function)
+{
+	static_assert(std::is_trivially_copyable_v<Genotype> && std::is_trivially_copyable_v<Value>,
+			"Evaluator frames hold raw bytes of genotypes and scores");
+
+	std::vector<Genotype> genotypes;
+	std::vector<Value> scores;
+	EvaluatorFrameHeader header{};
+	while (ReadFrameBytes(input, &header, sizeof(header)))
+	{
+		if (header.magic_ != evaluator_frame_magic || header.element_size_ != sizeof(Genotype))
+		{
+			throw std::runtime_error("Incompatible evaluator request");
+		}
+
+		genotypes.resize(header.count_);
+		scores.resize(header.count_);
+		if (!ReadFrameBytes(input, genotypes.data(), genotypes.size() * sizeof(Genotype)) && header.count_ != 0)
+		{
+			throw std::runtime_error("Evaluator request is cut short");
+		}
+
+		function(genotypes.data(), genotypes.size(), scores.data());
+
+		header.element_size_ = sizeof(Value);
+		WriteFrameBytes(output, &header, sizeof(header));
+		WriteFrameBytes(output, scores.data(), scores.size() * sizeof(Value));
+	}
+}
+
+} // GeneticAlgorithm
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stable.h"
+#include "GenotypeHash.h"
+
+namespace GA
+{
+
+struct FitnessCacheStatistics
+{
+	uint64_t hit_count_ = 0;
+	uint64_t disk_hit_count_ = 0;
+	uint64_t miss_count_ = 0;
+
+	double HitRate() const
+	{
+		const uint64_t lookup_count = hit_count_ + miss_count_;
+		return lookup_count == 0 ? 0.0 : static_cast<double>(hit_count_) / static_cast<double>(lookup_count);
+	}
+};
+
+//! Cache file: FitnessCacheFileHeader, then slot_count_ open addressing slots with linear probing.
+struct FitnessCacheFileHeader
+{
+	char magic_[8];
+	uint32_t version_;
+	uint32_t header_size_;
+	uint64_t genotype_size_;
+	uint64_t value_size_;
+	uint64_t slot_count_;
+	uint64_t entry_count_;
+	uint64_t reserved_[2];
+};
+
+static_assert(sizeof(FitnessCacheFileHeader) == 64, "Fitness cache header must stay 64 bytes");
+
+//! Scores of already evaluated genotypes, shared by any number of threads and solvers.
+//! New scores live in a sharded hash table. A cache opened with a file also reads the scores saved there
+//! by earlier runs straight from the mapped file, and Save merges both into the file.
+//! The file keeps raw bytes, so it needs trivially copyable genotypes and values,
+//! and it is valid only for the fitness function that produced it.
+template <typename Genotype, typename Value, typename Hash = GenotypeHash<Genotype>>
+class FitnessCache
+{
+	struct Slot
+	{
+		uint64_t hash_;
+		uint64_t is_used_;
+		Genotype genotype_;
+		Value value_;
+	};
+
+	//! Open addressing with linear probing in slots of the file layout, the table doubles
+	//! when it gets half full, so a cache that has stopped growing doesn't allocate.
+	struct Shard
+	{
+		std::mutex mutex_;
+		std::vector<Slot> table_;
+		size_t entry_count_ = 0;
+	};
+
+public:
+
+	FitnessCache() = default;
+
+	//! Maps the file when it exists, Save creates or replaces it.
+	explicit FitnessCache(const std::string& file_name)
+			: file_name_(file_name)
+	{
+		static_assert(std::is_trivially_copyable_v<Slot>, "Cached genotypes and values must be trivially copyable");
+		Map();
+	}
+
+	FitnessCache(const FitnessCache&) = delete;
+	FitnessCache& operator=(const FitnessCache&) = delete;
+
+	bool Find(const Genotype& genotype, Value& value)
+	{
+		const uint64_t hash = Hash::Hash(genotype);
+
+		Shard& shard = shards_[ShardIndex(hash)];
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex_);
+			if (const Slot* slot = FindInShard(shard, hash, genotype))
+			{
+				value = slot->value_;
+				hit_count_.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		if (const Slot* slot = FindMapped(hash, genotype))
+		{
+			value = slot->value_;
+			hit_count_.fetch_add(1, std::memory_order_relaxed);
+			disk_hit_count_.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		miss_count_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	void Insert(const Genotype& genotype, const Value& value)
+	{
+		const uint64_t hash = Hash::Hash(genotype);
+		Shard& shard = shards_[ShardIndex(hash)];
+		std::lock_guard<std::mutex> lock(shard.mutex_);
+		if (2 * (shard.entry_count_ + 1) > shard.table_.size())
+		{
+			GrowShard(shard);
+		}
+		if (StoreInTable(shard.table_, hash, genotype, value))
+		{
+			++shard.entry_count_;
+		}
+	}
+
+	FitnessCacheStatistics Statistics() const
+	{
+		FitnessCacheStatistics statistics;
+		statistics.hit_count_ = hit_count_.load(std::memory_order_relaxed);
+		statistics.disk_hit_count_ = disk_hit_count_.load(std::memory_order_relaxed);
+		statistics.miss_count_ = miss_count_.load(std::memory_order_relaxed);
+		return statistics;
+	}
+
+	//! Writes the mapped and the new scores into a new file and puts it in place of the old one.
+	//! Must not run concurrently with Find or Insert.
+	void Save()
+	{
+		if (file_name_.empty())
+		{
+			throw std::runtime_error("Fitness cache has no file");
+		}
+
+		size_t entry_count = header_ ? header_->entry_count_ : 0;
+		for (auto& shard : shards_)
+		{
+			entry_count += shard.entry_count_;
+		}
+
+		size_t slot_count = 16;
+		while (slot_count < 2 * entry_count)
+		{
+			slot_count *= 2;
+		}
+
+		std::vector<Slot> slots(slot_count);
+		std::memset(static_cast<void*>(slots.data()), 0, slots.size() * sizeof(Slot));
+
+		uint64_t stored_count = 0;
+		for (auto& shard : shards_)
+		{
+			for (const Slot& slot : shard.table_)
+			{
+				if (slot.is_used_ && StoreInTable(slots, slot.hash_, slot.genotype_, slot.value_))
+				{
+					++stored_count;
+				}
+			}
+		}
+		for (size_t position = 0; header_ && position < header_->slot_count_; ++position)
+		{
+			const Slot& slot = slots_[position];
+			if (slot.is_used_ && StoreInTable(slots, slot.hash_, slot.genotype_, slot.value_))
+			{
+				++stored_count;
+			}
+		}
+
+		FitnessCacheFileHeader header{};
+		std::memcpy(header.magic_, file_magic_, sizeof(header.magic_));
+		header.version_ = file_version_;
+		header.header_size_ = sizeof(FitnessCacheFileHeader);
+		header.genotype_size_ = sizeof(Genotype);
+		header.value_size_ = sizeof(Value);
+		header.slot_count_ = slot_count;
+		header.entry_count_ = stored_count;
+
+		const std::string temporary_name = file_name_ + ".tmp";
+		std::FILE* file = std::fopen(temporary_name.c_str(), "wb");
+		if (!file)
+		{
+			throw std::runtime_error("Can't open fitness cache file: " + temporary_name);
+		}
+		const bool is_written = std::fwrite(&header, sizeof(header), 1, file) == 1
+				&& std::fwrite(slots.data(), sizeof(Slot), slots.size(), file) == slots.size();
+		if (std::fclose(file) != 0 || !is_written)
+		{
+			std::remove(temporary_name.c_str());
+			throw std::runtime_error("Can't write fitness cache file: " + temporary_name);
+		}
+		if (std::rename(temporary_name.c_str(), file_name_.c_str()) != 0)
+		{
+			throw std::runtime_error("Can't replace fitness cache file: " + file_name_);
+		}
+
+		for (auto& shard : shards_)
+		{
+			shard.table_.assign(shard.table_.size(), Slot{});
+			shard.entry_count_ = 0;
+		}
+		Unmap();
+		Map();
+	}
+
+	~FitnessCache()
+	{
+		Unmap();
+	}
+
+private:
+
+	static size_t ShardIndex(const uint64_t hash)
+	{
+		return static_cast<size_t>(hash >> 58) % shard_count_;
+	}
+
+	static const Slot* FindInShard(const Shard& shard, const uint64_t hash, const Genotype& genotype)
+	{
+		if (shard.table_.empty())
+		{
+			return nullptr;
+		}
+
+		const size_t mask = shard.table_.size() - 1;
+		for (size_t position = hash & mask; ; position = (position + 1) & mask)
+		{
+			const Slot& slot = shard.table_[position];
+			if (!slot.is_used_)
+			{
+				return nullptr;
+			}
+			if (slot.hash_ == hash && Hash::Equal(slot.genotype_, genotype))
+			{
+				return &slot;
+			}
+		}
+	}
+
+	//! false when the genotype is already there, table must have a free slot and a power of two size.
+	static bool StoreInTable(
+			std::vector<Slot>& table,
+			const uint64_t hash,
+			const Genotype& genotype,
+			const Value& value)
+	{
+		const size_t mask = table.size() - 1;
+		for (size_t position = hash & mask; ; position = (position + 1) & mask)
+		{
+			Slot& slot = table[position];
+			if (!slot.is_used_)
+			{
+				slot.hash_ = hash;
+				slot.is_used_ = 1;
+				slot.genotype_ = genotype;
+				slot.value_ = value;
+				return true;
+			}
+			if (slot.hash_ == hash && Hash::Equal(slot.genotype_, genotype))
+			{
+				return false;
+			}
+		}
+	}
+
+	static void GrowShard(Shard& shard)
+	{
+		std::vector<Slot> table(std::max<size_t>(16, 2 * shard.table_.size()));
+		for (const Slot& slot : shard.table_)
+		{
+			if (slot.is_used_)
+			{
+				StoreInTable(table, slot.hash_, slot.genotype_, slot.value_);
+			}
+		}
+		shard.table_.swap(table);
+	}
+
+	const Slot* FindMapped(const uint64_t hash, const Genotype& genotype) const
+	{
+		if (!header_)
+		{
+			return nullptr;
+		}
+
+		const size_t mask = header_->slot_count_ - 1;
+		for (size_t position = hash & mask; ; position = (position + 1) & mask)
+		{
+			const Slot& slot = slots_[position];
+			if (!slot.is_used_)
+			{
+				return nullptr;
+			}
+			if (slot.hash_ == hash && Hash::Equal(slot.genotype_, genotype))
+			{
+				return &slot;
+			}
+		}
+	}
+
+	void Map()
+	{
+		const int descriptor = ::open(file_name_.c_str(), O_RDONLY);
+		if (descriptor < 0)
+		{
+			return;
+		}
+
+		struct stat file_stat{};
+		if (::fstat(descriptor, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(FitnessCacheFileHeader)))
+		{
+			::close(descriptor);
+			throw std::runtime_error("Can't read fitness cache file: " + file_name_);
+		}
+
+		size_ = static_cast<size_t>(file_stat.st_size);
+		void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		::close(descriptor);
+		if (data == MAP_FAILED)
+		{
+			throw std::runtime_error("Can't map fitness cache file: " + file_name_);
+		}
+		data_ = static_cast<const unsigned char*>(data);
+
+		const auto* header = reinterpret_cast<const FitnessCacheFileHeader*>(data_);
+		const bool is_valid = std::memcmp(header->magic_, file_magic_, sizeof(header->magic_)) == 0
+				&& header->version_ == file_version_
+				&& header->header_size_ == sizeof(FitnessCacheFileHeader)
+				&& header->genotype_size_ == sizeof(Genotype)
+				&& header->value_size_ == sizeof(Value)
+				&& header->slot_count_ != 0
+				&& (header->slot_count_ & (header->slot_count_ - 1)) == 0
+				&& header->entry_count_ < header->slot_count_
+				&& size_ == sizeof(FitnessCacheFileHeader) + header->slot_count_ * sizeof(Slot);
+		if (!is_valid)
+		{
+			Unmap();
+			throw std::runtime_error("Incompatible fitness cache file: " + file_name_);
+		}
+
+		header_ = header;
+		slots_ = reinterpret_cast<const Slot*>(data_ + sizeof(FitnessCacheFileHeader));
+	}
+
+	void Unmap()
+	{
+		if (data_)
+		{
+			::munmap(const_cast<unsigned char*>(data_), size_);
+		}
+		data_ = nullptr;
+		size_ = 0;
+		header_ = nullptr;
+		slots_ = nullptr;
+	}
+
+	constexpr static size_t shard_count_ = 64;
+	constexpr static char file_magic_[8] = {'G', 'A', 'F', 'C', 'A', 'C', '0', '1'};
+	constexpr static uint32_t file_version_ = 1;
+
+	std::string file_name_;
+	Shard shards_[shard_count_];
+
+	const unsigned char* data_ = nullptr;
+	size_t size_ = 0;
+	const FitnessCacheFileHeader* header_ = nullptr;
+	const Slot* slots_ = nullptr;
+
+	std::atomic<uint64_t> hit_count_{0};
+	std::atomic<uint64_t> disk_hit_count_{0};
+	std::atomic<uint64_t> miss_count_{0};
+};
+
+template <typename Genotype, typename Value, typename Hash = GenotypeHash<Genotype>>
+using FitnessCachePtr = std::shared_ptr<FitnessCache<Genotype, Value, Hash>>;
+
+} // GeneticAlgorithm
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include "stable.h"
+#include "AllocationCounter.h"
+
+namespace GA
+{
+
+enum class ProfilePhase
+{
+	Selection,
+	Ranking,
+	Crossingover,
+	Mutation,
+	Fitness,
+	ConvergenceCheck,
+};
+
+constexpr size_t profile_phase_count = static_cast<size_t>(ProfilePhase::ConvergenceCheck) + 1;
+
+inline const char* ProfilePhaseName(const ProfilePhase phase)
+{
+	constexpr const char* names[profile_phase_count] = {
+			"selection", "ranking", "crossingover", "mutation", "fitness", "convergence_check"};
+	return names[static_cast<size_t>(phase)];
+}
+
+//! Where one generation spent its time, in steady clock nanoseconds.
+struct GenerationProfile
+{
+	std::array<long, profile_phase_count> times_{};
+	size_t evaluation_count_ = 0;
+	size_t allocation_count_ = 0;
+
+	long& Time(const ProfilePhase phase)
+	{
+		return times_[static_cast<size_t>(phase)];
+	}
+
+	long Time(const ProfilePhase phase) const
+	{
+		return times_[static_cast<size_t>(phase)];
+	}
+};
+
+using RunProfile = std::vector<GenerationProfile>;
+
+//! Adds the time since the previous lap to a phase of the generation profile.
+class PhaseClock
+{
+	using Clock = std::chrono::steady_clock;
+
+public:
+
+	explicit PhaseClock(GenerationProfile& profile)
+			: profile_(profile)
+			, allocation_start_(AllocationCount())
+			, lap_start_(Clock::now())
+	{}
+
+	void Lap(const ProfilePhase phase)
+	{
+		const auto now = Clock::now();
+		profile_.Time(phase) += std::chrono::duration_cast<std::chrono::nanoseconds>(now - lap_start_).count();
+		profile_.allocation_count_ = AllocationCount() - allocation_start_;
+		lap_start_ = now;
+	}
+
+	void CountEvaluations(const size_t count)
+	{
+		profile_.evaluation_count_ += count;
+	}
+
+private:
+	GenerationProfile& profile_;
+	uint64_t allocation_start_;
+	Clock::time_point lap_start_;
+};
+
+//! Used when profiling is off, every call compiles to nothing.
+struct NullPhaseClock
+{
+	void Lap(ProfilePhase)
+	{}
+
+	void CountEvaluations(size_t)
+	{}
+};
+
+} // GeneticAlgorithm
@@ -5,63 +5,57 @@
 #include <chrono>
 #include "stable.h"
 
+#include "ChangedIndexes.h"
+#include "Checkpoint.h"
+#include "GenerationProfile.h"
 #include "ISelectionFunction.h"
 #include "IGeneticAlgorithmStrategy.h"
+#include "IStateSink.h"
+#include "PopulationRanker.h"
+#include "PopulationStatistics.h"
+#include "Random.h"
+#include "ScratchArena.h"
+#include "State.h"
+#include "StrategyTraits.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 
 namespace GA
 {
 
-template <typename Genotype>
-using Population = std::vector<Genotype>;
-
-template <typename ScoreValue>
-using ScorePopulation = std::vector<ScoreValue>;
-
-template <typename Genotype, typename ScoreValue>
-struct State
-{
-	Population<Genotype> current_population_;
-	ScorePopulation<ScoreValue> current_population_score_;
-
-	State& operator=(const State<Genotype, ScoreValue>& state)
-	{
-		if (&state == this)
-		{
-			return *this;
-		}
-
-		current_population_score_ = state.current_population_score_;
-		current_population_ = state.current_population_;
-
-		return *this;
-	}
-};
-
-template <typename Genotype, typename ScoreValue>
-using States = std::vector<State<Genotype, ScoreValue>>;
-
 template <typename Genotype, typename ScoreValue>
 struct GeneticAlgorithmResult
 {
 	State<Genotype, ScoreValue> final_state_;
 	size_t iteration_count_ = 0;
+	uint64_t seed_ = 0;
 	std::optional<States<Genotype, ScoreValue>> states_ = std::nullopt;
 	std::optional<long> times_ = std::nullopt;
+	std::optional<RunProfile> profile_ = std::nullopt;
 };
 
-template <typename Genotype, typename ScoreValue>
-class GeneticAlgorithm
+//! Strategy and Selector are called through their static types: with the interfaces every call is virtual,
+//! with concrete final classes the calls are bound at compile time and can be inlined.
+template <typename Strategy, typename Selector>
+class BasicGeneticAlgorithm
 {
     using Index = size_t;
     using Indexes = std::vector<Index>;
-    using GreatDoubleIndexMap = std::multimap<double, Index, std::greater<>>;
 
 public:
 
-    explicit GeneticAlgorithm(
-            const ISelectionFunctionPtr<ScoreValue>& selector,
-            const IGeneticAlgorithmStrategyPtr<Genotype, ScoreValue>& strategy)
+	using StrategyType = Strategy;
+	using SelectorType = Selector;
+	using Genotype = typename Strategy::GenotypeType;
+	using ScoreValue = typename Strategy::ValueType;
+
+	static_assert(IsGeneticAlgorithmStrategy<Strategy>::value, "Strategy doesn't provide the genetic operators");
+	static_assert(IsSelectionFunction<Selector, ScoreValue>::value, "Selector doesn't provide Selection");
+
+    explicit BasicGeneticAlgorithm(
+            const std::shared_ptr<Selector>& selector,
+            const std::shared_ptr<Strategy>& strategy,
+            const size_t thread_count = 1)
             : selector_(selector)
             , strategy_(strategy)
     {
@@ -73,35 +67,196 @@ public:
         {
             throw std::runtime_error("Empty strategy");
         }
+        if (thread_count == 0)
+        {
+            throw std::runtime_error("Thread count must be positive");
+        }
+        if (thread_count > 1)
+        {
+            thread_pool_ = std::make_shared<ThreadPool>(thread_count);
+        }
+    }
+
+    size_t ThreadCount() const
+    {
+        return thread_pool_ ? thread_pool_->ThreadCount() : 1;
     }
 
-    template <bool IsSaveState = false, bool IsMeasuringTime = false>
+    //! IsProfiling fills profile_ with the phase times of every generation.
+    template <bool IsSaveState = false, bool IsMeasuringTime = false, bool IsProfiling = false>
     GeneticAlgorithmResult<Genotype, ScoreValue> Calculation(
             const double mutation_part,
             const double crossingover_part,
-            const size_t limit = 1000) const
+            const size_t limit = 1000,
+            const uint64_t seed = std::random_device{}(),
+            const IStateSinkPtr<Genotype, ScoreValue>& sink = nullptr) const
     {
         assert(mutation_part > 0.0 && mutation_part < 1.0);
         assert(crossingover_part > 0.0 && mutation_part < 1.0);
 
-		long start_time = 0;
+		std::chrono::steady_clock::time_point start_time;
+        if constexpr (IsMeasuringTime)
+		{
+			start_time = std::chrono::steady_clock::now();
+		}
+
+		GeneticAlgorithmResult<Genotype, ScoreValue> result;
+		result.seed_ = seed;
+
+		const RandomStreams streams(seed);
+		Workspace workspace;
+		Initialize(streams, result.final_state_, workspace);
+
+		Run<IsSaveState, IsMeasuringTime, IsProfiling>(
+				mutation_part, crossingover_part, limit, streams, sink, start_time, workspace, result);
+        return result;
+    }
+
+    //! Continues a run from its checkpoint. With the same limit and strategy the result is the one
+    //! the run would have had without the interruption, states, times and profile cover only the continued part.
+    template <bool IsSaveState = false, bool IsMeasuringTime = false, bool IsProfiling = false>
+    GeneticAlgorithmResult<Genotype, ScoreValue> Resume(
+            const Checkpoint<Genotype, ScoreValue>& checkpoint,
+            const size_t limit = 1000,
+            const IStateSinkPtr<Genotype, ScoreValue>& sink = nullptr) const
+    {
+		std::chrono::steady_clock::time_point start_time;
         if constexpr (IsMeasuringTime)
 		{
-			const long current_time_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-			start_time = current_time_nanoseconds;
+			start_time = std::chrono::steady_clock::now();
+		}
+
+		if (checkpoint.state_.current_population_.size() != checkpoint.state_.current_population_score_.size())
+		{
+			throw std::runtime_error("Checkpoint population and scores differ in size");
 		}
 
 		GeneticAlgorithmResult<Genotype, ScoreValue> result;
+		result.seed_ = checkpoint.seed_;
+		result.iteration_count_ = checkpoint.iteration_count_;
+		result.final_state_ = checkpoint.state_;
+
+		const RandomStreams streams(checkpoint.seed_);
+		Workspace workspace;
+		UpdateStatistics(result.final_state_, workspace);
+
+		Run<IsSaveState, IsMeasuringTime, IsProfiling>(
+				checkpoint.mutation_part_, checkpoint.crossingover_part_, limit, streams, sink, start_time,
+				workspace, result);
+        return result;
+    }
+
+	//! Buffers reused by every generation of one run and the statistics of the last two generations.
+	//! Once they have grown to the population size, a generation doesn't allocate.
+	struct Workspace
+	{
+		std::vector<double> selection_keys_;
+		ScratchArena selection_arena_;
+		PopulationRanker ranker_;
+		Population<Genotype> next_population_;
+		ScorePopulation<ScoreValue> next_scores_;
+		std::vector<typename Population<Genotype>::iterator> sampler_;
+		ChangedIndexes changed_;
+		Population<Genotype> changed_genotypes_;
+		ScorePopulation<ScoreValue> changed_scores_;
+		PopulationStatisticsAccumulator<ScoreValue> statistics_accumulator_;
+		PopulationStatistics<ScoreValue> statistics_;
+		PopulationStatistics<ScoreValue> previous_statistics_;
+	};
+
+	//! Creates and scores the start population.
+	void Initialize(const RandomStreams& streams, State<Genotype, ScoreValue>& state, Workspace& workspace) const
+	{
+		auto start_generator = streams.Stream(RandomStreamPurpose::StartPopulation, 0, 0);
+
+		state.current_population_ = strategy_->CreateStartPopulation(start_generator);
+		state.current_population_score_.resize(state.current_population_.size());
+
+		ApplyFitnessFuntionToPopulation(state, workspace);
+	}
+
+	//! Makes one generation: crossingover, mutation and scoring of the new population, then ends it in the strategy.
+	//! With an incremental strategy only the individuals changed by crossingover or mutation are scored again,
+	//! code that changes genotypes between steps must set their scores itself.
+	//! clock is a PhaseClock to profile the phases.
+	template <typename Clock = NullPhaseClock>
+	void Step(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t iteration_count,
+			const RandomStreams& streams,
+			State<Genotype, ScoreValue>& state,
+			Workspace& workspace,
+			Clock&& clock = Clock{}) const
+	{
+		workspace.changed_.Resize(state.current_population_.size());
+		workspace.previous_statistics_ = workspace.statistics_;
+
+		ApplyCrossingoverToPopulation(crossingover_part, iteration_count, streams, state, workspace, clock);
+		ApplyMutationToPopulation(mutation_part, iteration_count, streams, state, workspace);
+		clock.Lap(ProfilePhase::Mutation);
+		size_t evaluation_count = state.current_population_.size();
+		if (strategy_->IsIncrementalFitness())
+		{
+			evaluation_count = ApplyFitnessFuntionToChanged(state, workspace);
+			UpdateStatistics(state, workspace);
+		}
+		else
+		{
+			ApplyFitnessFuntionToPopulation(state, workspace);
+		}
+		clock.Lap(ProfilePhase::Fitness);
+		clock.CountEvaluations(evaluation_count);
+
+		strategy_->EndGeneration();
+	}
+
+	//! Compares the statistics of the last generation with the previous one.
+	bool IsCorrectResult(const State<Genotype, ScoreValue>& state, const Workspace& workspace) const
+	{
+		return strategy_->IsCorrectResult(
+				state.current_population_, state.current_population_score_,
+				workspace.previous_statistics_, workspace.statistics_);
+	}
 
-		result.final_state_.current_population_ = strategy_->CreateStartPopulation();
-		result.final_state_.current_population_score_.resize(result.final_state_.current_population_.size());
+	//! Recomputes the statistics after the scores were changed outside of Step, e.g. by migration.
+	void UpdateStatistics(const State<Genotype, ScoreValue>& state, Workspace& workspace) const
+	{
+		const auto& scores = state.current_population_score_;
+		workspace.statistics_accumulator_.Reset(ChunkCount(scores.size()));
+		ParallelFor(scores.size(), fitness_chunk_size_,
+				[&scores, &workspace](const size_t begin, const size_t end)
+				{
+					workspace.statistics_accumulator_.AddChunk(
+							begin / fitness_chunk_size_, scores.data(), begin, end);
+				});
+		workspace.statistics_ = workspace.statistics_accumulator_.Combine();
+	}
+
+protected:
 
+	//! Makes generations from result.final_state_ until the limit or convergence.
+	template <bool IsSaveState, bool IsMeasuringTime, bool IsProfiling>
+	void Run(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit,
+			const RandomStreams& streams,
+			const IStateSinkPtr<Genotype, ScoreValue>& sink,
+			const std::chrono::steady_clock::time_point start_time,
+			Workspace& workspace,
+			GeneticAlgorithmResult<Genotype, ScoreValue>& result) const
+	{
 		if constexpr (IsSaveState)
 		{
 			result.states_ = std::make_optional<States<Genotype, ScoreValue>>();
 		}
 
-		ApplyFitnessFuntionToPopulation(result.final_state_);
+		if constexpr (IsProfiling)
+		{
+			// Runs usually stop on convergence long before the limit, the profile grows with the generations
+			result.profile_ = std::make_optional<RunProfile>();
+		}
 
 		bool is_not_result_correct;
 	 	bool is_not_iter_limit;
@@ -113,135 +268,263 @@ public:
 				result.states_->push_back(result.final_state_);
 			}
 
-            ApplyCrossingoverToPopulation(crossingover_part, result.final_state_);
-            ApplyMutationToPopulation(mutation_part, result.iteration_count_, result.final_state_);
-			ApplyFitnessFuntionToPopulation(result.final_state_);
-			result.iteration_count_++;
+			if (sink)
+			{
+				sink->Consume(result.iteration_count_, result.final_state_);
+			}
+
+			if constexpr (IsProfiling)
+			{
+				result.profile_->emplace_back();
+				PhaseClock clock(result.profile_->back());
+
+				Step(mutation_part, crossingover_part, result.iteration_count_, streams, result.final_state_, workspace, clock);
+				result.iteration_count_++;
 
-            is_not_result_correct = !strategy_->
-            		IsCorrectResult(result.final_state_.current_population_, result.final_state_.current_population_score_);
+				is_not_result_correct = !IsCorrectResult(result.final_state_, workspace);
+				clock.Lap(ProfilePhase::ConvergenceCheck);
+			}
+			else
+			{
+				Step(mutation_part, crossingover_part, result.iteration_count_, streams, result.final_state_, workspace);
+				result.iteration_count_++;
+
+				is_not_result_correct = !IsCorrectResult(result.final_state_, workspace);
+			}
             is_not_iter_limit = static_cast<const bool>(result.iteration_count_ < limit);
         }
         while (is_not_result_correct && is_not_iter_limit);
 
+		if (sink)
+		{
+			sink->Finish();
+		}
+
 		if constexpr (IsMeasuringTime)
 		{
-			const long current_time_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-			result.times_ = current_time_nanoseconds - start_time;
+			result.times_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_time).count();
 		}
+	}
 
-        return result;
+	//! Statistics of a chunk are collected right after it is scored.
+    void ApplyFitnessFuntionToPopulation(State<Genotype, ScoreValue>& state, Workspace& workspace) const
+    {
+		workspace.statistics_accumulator_.Reset(ChunkCount(state.current_population_.size()));
+		ParallelFor(state.current_population_.size(), fitness_chunk_size_,
+				[this, &state, &workspace](const size_t begin, const size_t end)
+				{
+					strategy_->FitnessFunctionBatch(
+							state.current_population_.data() + begin,
+							end - begin,
+							state.current_population_score_.data() + begin);
+					workspace.statistics_accumulator_.AddChunk(
+							begin / fitness_chunk_size_, state.current_population_score_.data(), begin, end);
+				});
+		workspace.statistics_ = workspace.statistics_accumulator_.Combine();
     }
 
-protected:
+	static size_t ChunkCount(const size_t count)
+	{
+		return (count + fitness_chunk_size_ - 1) / fitness_chunk_size_;
+	}
 
-    void ApplyFitnessFuntionToPopulation(State<Genotype, ScoreValue>& state) const
-    {
-        std::transform(
-        		state.current_population_.begin(),
-				state.current_population_.end(),
-				state.current_population_score_.begin(),
-                [this](const auto& genotype)
-                {
-                    return strategy_->FitnessFunction(genotype);
-                });
-    }
+	//! Gathers the changed individuals into contiguous buffers, so a strategy still gets whole batches,
+	//! and scatters the scores back. Returns the number of evaluated individuals.
+	size_t ApplyFitnessFuntionToChanged(State<Genotype, ScoreValue>& state, Workspace& workspace) const
+	{
+		// The buffers only grow, so genotypes that own memory keep it for the next generations
+		const auto& changed = workspace.changed_.Collect();
+		if (workspace.changed_genotypes_.size() < changed.size())
+		{
+			workspace.changed_genotypes_.resize(changed.size());
+			workspace.changed_scores_.resize(changed.size());
+		}
+
+		ParallelFor(changed.size(), fitness_chunk_size_,
+				[this, &state, &workspace, &changed](const size_t begin, const size_t end)
+				{
+					for (size_t position = begin; position < end; ++position)
+					{
+						workspace.changed_genotypes_[position] = state.current_population_[changed[position]];
+					}
+
+					strategy_->FitnessFunctionBatch(
+							workspace.changed_genotypes_.data() + begin,
+							end - begin,
+							workspace.changed_scores_.data() + begin);
+
+					for (size_t position = begin; position < end; ++position)
+					{
+						state.current_population_score_[changed[position]] = workspace.changed_scores_[position];
+					}
+				});
+		return changed.size();
+	}
+
+	template <typename ChunkFunction>
+	void ParallelFor(const size_t count, const size_t chunk_size, ChunkFunction&& function) const
+	{
+		if (thread_pool_)
+		{
+			thread_pool_->ParallelFor(count, chunk_size, function);
+			return;
+		}
+
+		for (size_t begin = 0; begin < count; begin += chunk_size)
+		{
+			function(begin, std::min(begin + chunk_size, count));
+		}
+	}
 
     void ApplyMutationToPopulation(
     		const double mutation_part,
     		const size_t iteration_count,
-			State<Genotype, ScoreValue>& state) const
+    		const RandomStreams& streams,
+			State<Genotype, ScoreValue>& state,
+			Workspace& workspace) const
     {
         const size_t mutation_count = static_cast<size_t>(mutation_part * state.current_population_.size());
 
-        std::vector<typename Population<Genotype>::iterator> sampler(mutation_count);
+        auto& sampler = workspace.sampler_;
+        sampler.resize(mutation_count);
         sample_iterator(state.current_population_.begin(), state.current_population_.end(),
-                sampler.begin(), mutation_count, std::mt19937{std::random_device{}()});
-
-        for (auto& sample : sampler)
-        {
-            *sample = strategy_->Mutation(*sample, iteration_count);
-        }
+                sampler.begin(), mutation_count,
+                streams.Stream(RandomStreamPurpose::Sampling, iteration_count, 0));
+
+		auto& changed = workspace.changed_;
+		const auto population_begin = state.current_population_.begin();
+		ParallelFor(sampler.size(), mutation_chunk_size_,
+				[this, &sampler, &streams, &changed, population_begin, iteration_count](const size_t begin, const size_t end)
+				{
+					for (size_t position = begin; position < end; ++position)
+					{
+						auto& sample = sampler[position];
+						const auto index = static_cast<Index>(sample - population_begin);
+						auto generator = streams.Stream(RandomStreamPurpose::Mutation, iteration_count, index);
+						strategy_->MutationInPlace(*sample, iteration_count, generator);
+						changed.Mark(index);
+					}
+				});
     }
 
+    template <typename Clock = NullPhaseClock>
     void ApplyCrossingoverToPopulation(
     		const double crossingover_part,
-			State<Genotype, ScoreValue>& state) const
+    		const size_t iteration_count,
+    		const RandomStreams& streams,
+			State<Genotype, ScoreValue>& state,
+			Workspace& workspace,
+			Clock&& clock = Clock{}) const
     {
         const size_t crossingover_count =
         		static_cast<const size_t>(state.current_population_.size() * crossingover_part);
 		const size_t not_crossingover_count = state.current_population_.size() - crossingover_count;
 
-		const GreatDoubleIndexMap& distribution_population = GetSurviveDistributionPopulation(state);
-		const Indexes& survives = GetSurviveIndices(crossingover_count, not_crossingover_count, distribution_population);
+		GetSurviveDistributionPopulation(
+				not_crossingover_count, state,
+				streams.Stream(RandomStreamPurpose::Selection, iteration_count, 0),
+				workspace, clock);
 
-		Crossingover(crossingover_count, not_crossingover_count, distribution_population, survives, state);
+		Crossingover(iteration_count, streams, state, workspace);
+		clock.Lap(ProfilePhase::Crossingover);
 	}
 
-private:
-
+	//! Children of the ranked population are written into the next buffers of the workspace
+	//! while their parents are read from the current ones, so children are made in parallel.
+	//! The survivors are copied over and the buffers are swapped with the state.
 	void Crossingover(
-			const size_t crossingover_count,
-			const size_t not_crossingover_count,
-			const GreatDoubleIndexMap& distribution_population,
-			const Indexes& survives,
-			State<Genotype, ScoreValue>& state) const
+			const size_t iteration_count,
+			const RandomStreams& streams,
+			State<Genotype, ScoreValue>& state,
+			Workspace& workspace) const
 	{
-		std::mt19937 generator(std::random_device{}());
-		std::uniform_int_distribution<Index> distribution(0, crossingover_count - 1);
-
-		size_t count = 0;
-		auto distribution_population_iter = distribution_population.begin();
-		do
-		{
-			const auto& [score, index] = *distribution_population_iter++;
-
-			Index first_parent_index = distribution(generator);
-			Index second_parent_index = distribution(generator);
-
-			const Genotype& first_parent = state.current_population_[survives[first_parent_index]];
-			const Genotype& second_parent = state.current_population_[survives[second_parent_index]];
-
-			const double first_score = state.current_population_score_[survives[first_parent_index]];
-			const double second_score = state.current_population_score_[survives[second_parent_index]];
-
-			state.current_population_[index] =
-					strategy_->Crossingover(first_parent, first_score, second_parent, second_score);
-		}
-		while (count++ != not_crossingover_count);
+		const auto& ranker = workspace.ranker_;
+		const auto& population = state.current_population_;
+		const auto& scores = state.current_population_score_;
+		auto& next_population = workspace.next_population_;
+		auto& next_scores = workspace.next_scores_;
+		auto& changed = workspace.changed_;
+		next_population.resize(population.size());
+		next_scores.resize(scores.size());
+
+		ParallelFor(ranker.ReplacedCount(), crossingover_chunk_size_,
+				[this, &ranker, &streams, &population, &scores, &next_population, &changed, iteration_count](
+						const size_t begin, const size_t end)
+				{
+					std::uniform_int_distribution<Index> distribution(0, ranker.SurvivedCount() - 1);
+					for (size_t position = begin; position < end; ++position)
+					{
+						const Index index = ranker.Replaced(position);
+						auto generator = streams.Stream(RandomStreamPurpose::Crossingover, iteration_count, position);
+
+						const Index first_parent_index = ranker.Survived(distribution(generator));
+						const Index second_parent_index = ranker.Survived(distribution(generator));
+
+						strategy_->CrossingoverInto(
+								population[first_parent_index], scores[first_parent_index],
+								population[second_parent_index], scores[second_parent_index],
+								next_population[index],
+								generator);
+						changed.Mark(index);
+					}
+				});
+
+		// The first survivor is also the last replaced individual and already has its child
+		ParallelFor(ranker.SurvivedCount() - 1, crossingover_chunk_size_,
+				[&ranker, &population, &scores, &next_population, &next_scores](const size_t begin, const size_t end)
+				{
+					for (size_t position = begin + 1; position < end + 1; ++position)
+					{
+						const Index index = ranker.Survived(position);
+						next_population[index] = population[index];
+						next_scores[index] = scores[index];
+					}
+				});
+
+		state.current_population_.swap(next_population);
+		state.current_population_score_.swap(next_scores);
 	}
 
-	Indexes GetSurviveIndices(
-			const size_t crossingover_count,
+	//! Ranks the population by the keys of the selector, the keys and selector buffers live in the workspace.
+	template <typename Clock = NullPhaseClock>
+	void GetSurviveDistributionPopulation(
 			const size_t not_crossingover_count,
-			const GreatDoubleIndexMap& distribution_population) const
+			const State<Genotype, ScoreValue>& state,
+			RandomGenerator generator,
+			Workspace& workspace,
+			Clock&& clock = Clock{}) const
 	{
-		Indexes survives(crossingover_count);
-		auto start_survive_genotype_iterator = distribution_population.begin();
-		std::advance(start_survive_genotype_iterator, not_crossingover_count);
-		std::transform(start_survive_genotype_iterator, distribution_population.end(), survives.begin(),
-				std::mem_fn(&GreatDoubleIndexMap::value_type::second));
-
-		return survives;
+		const auto& scores = state.current_population_score_;
+		workspace.selection_keys_.resize(scores.size());
+		selector_->Selection(
+				scores.data(), scores.size(), workspace.statistics_, generator,
+				workspace.selection_arena_, workspace.selection_keys_.data());
+		clock.Lap(ProfilePhase::Selection);
+		workspace.ranker_.Rank(workspace.selection_keys_, not_crossingover_count);
+		clock.Lap(ProfilePhase::Ranking);
 	}
 
-	GreatDoubleIndexMap GetSurviveDistributionPopulation(const State<Genotype, ScoreValue>& state) const
-	{
-		const auto& survive_chance = selector_->Selection(state.current_population_score_);
-		GreatDoubleIndexMap distribution_population;
-		{
-			for (size_t index = 0; index < state.current_population_.size(); ++index)
-			{
-				distribution_population.emplace(survive_chance[index], index);
-			}
-		}
-		return distribution_population;
-	}
+private:
+
+	constexpr static size_t fitness_chunk_size_ = 1024;
+	constexpr static size_t mutation_chunk_size_ = 1024;
+	constexpr static size_t crossingover_chunk_size_ = 1024;
 
-    ISelectionFunctionPtr<ScoreValue> selector_;
-    IGeneticAlgorithmStrategyPtr<Genotype, ScoreValue> strategy_;
+    std::shared_ptr<Selector> selector_;
+    std::shared_ptr<Strategy> strategy_;
+    ThreadPoolPtr thread_pool_;
 };
 
+template <typename Strategy, typename Selector>
+using BasicGeneticAlgorithmPtr = std::shared_ptr<BasicGeneticAlgorithm<Strategy, Selector>>;
+
+//! Solver bound to the strategy and selector at run time.
+template <typename Genotype, typename ScoreValue>
+using GeneticAlgorithm = BasicGeneticAlgorithm<
+		IGeneticAlgorithmStrategy<Genotype, ScoreValue>,
+		ISelectionFunction<ScoreValue>>;
+
 template <typename Genotype, typename ScoreValue>
 using GeneticAlgorithmPtr = std::shared_ptr<GeneticAlgorithm<Genotype, ScoreValue>>;
 
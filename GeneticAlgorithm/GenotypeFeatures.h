@@ -0,0 +1,14 @@
+#pragma once
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Strategies opt in to surrogate models by specializing it for their genotype with
+//! constexpr static size_t count_ and static void Extract(const Genotype&, double* features),
+//! which writes count_ coordinates; genotypes close in these coordinates should have close scores.
+template <typename Genotype>
+struct GenotypeFeatures;
+
+} // GeneticAlgorithm
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstring>
+
+#include "stable.h"
+#include "Random.h"
+
+namespace GA
+{
+
+//! Strategies opt in to fitness caching by specializing it for their genotype with
+//! static uint64_t Hash(const Genotype&) and static bool Equal(const Genotype&, const Genotype&).
+//! Equal genotypes must have equal hashes.
+template <typename Genotype>
+struct GenotypeHash;
+
+//! Hash of the object representation, for trivially copyable genotypes without padding bytes.
+template <typename Genotype>
+uint64_t HashBytes(const Genotype& genotype)
+{
+	static_assert(std::is_trivially_copyable_v<Genotype>, "Only trivially copyable genotypes are hashed by bytes");
+
+	unsigned char bytes[sizeof(Genotype)];
+	std::memcpy(bytes, &genotype, sizeof(Genotype));
+
+	uint64_t hash = sizeof(Genotype);
+	size_t position = 0;
+	for (; position + sizeof(uint64_t) <= sizeof(Genotype); position += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes + position, sizeof(word));
+		hash = MixHash(hash ^ word);
+	}
+	if (position < sizeof(Genotype))
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, bytes + position, sizeof(Genotype) - position);
+		hash = MixHash(hash ^ word);
+	}
+	return hash;
+}
+
+template <typename Genotype>
+bool EqualBytes(const Genotype& first, const Genotype& second)
+{
+	static_assert(std::is_trivially_copyable_v<Genotype>, "Only trivially copyable genotypes are compared by bytes");
+	return std::memcmp(&first, &second, sizeof(Genotype)) == 0;
+}
+
+} // GeneticAlgorithm
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "stable.h"
+#include "PopulationStatistics.h"
+#include "Random.h"
 
 namespace GA
 {
@@ -13,21 +15,82 @@ class IGeneticAlgorithmStrategy
 
 public:
 
-    virtual Population CreateStartPopulation() const = 0;
+	using GenotypeType = Genotype;
+	using ValueType = Value;
 
+    virtual Population CreateStartPopulation(RandomGenerator& generator) const = 0;
+
+    //! Writes count start genotypes into genotypes, for engines that keep the population out of memory
+    //! and create it in parts; every part gets its own generator.
+    virtual void CreateStartGenotypes(RandomGenerator& /*generator*/, Genotype* /*genotypes*/, const size_t /*count*/) const
+    {
+    	throw std::runtime_error("Strategy can't create its start population in parts");
+    }
+
+    //! May be called concurrently for different genotypes, all randomness must come from generator.
     virtual Genotype Mutation(
     		const Genotype& genotype,
-    		const size_t iteration_count) const = 0;
+    		const size_t iteration_count,
+    		RandomGenerator& generator) const = 0;
 
     virtual Genotype Crossingover(
     		const Genotype& first_parent, const Value first_score,
-    		const Genotype& second_parent, const Value second_score) const = 0;
+    		const Genotype& second_parent, const Value second_score,
+    		RandomGenerator& generator) const = 0;
+
+    //! In-place form of Mutation, override it when copying a genotype is expensive.
+    virtual void MutationInPlace(
+    		Genotype& genotype,
+    		const size_t iteration_count,
+    		RandomGenerator& generator) const
+    {
+    	genotype = Mutation(genotype, iteration_count, generator);
+    }
+
+    //! Writes the child of Crossingover into a preallocated slot of the next generation buffer,
+    //! which keeps the memory of an older genotype. May be called concurrently for different children.
+    virtual void CrossingoverInto(
+    		const Genotype& first_parent, const Value first_score,
+    		const Genotype& second_parent, const Value second_score,
+    		Genotype& child,
+    		RandomGenerator& generator) const
+    {
+    	child = Crossingover(first_parent, first_score, second_parent, second_score, generator);
+    }
 
     virtual Value FitnessFunction(const Genotype &genotype) const = 0;
 
+    //! Scores count genotypes into scores, override it to vectorize the fitness function.
+    virtual void FitnessFunctionBatch(
+    		const Genotype* genotypes,
+    		const size_t count,
+    		Value* scores) const
+    {
+    	for (size_t index = 0; index < count; ++index)
+    	{
+    		scores[index] = FitnessFunction(genotypes[index]);
+    	}
+    }
+
+    //! The engine scores again only the genotypes changed in a generation, this needs a pure fitness function.
+    //! Return false when scoring the whole population is cheaper than finding the changed part,
+    //! as it is for a vectorized fitness function that costs a few nanoseconds.
+    virtual bool IsIncrementalFitness() const
+    {
+    	return true;
+    }
+
+    //! Called by every engine once a generation, after its scores are known and before the next one starts,
+    //! lets a strategy update what it learned from the evaluations. Engines may check convergence less often.
+    virtual void EndGeneration() const
+    {}
+
+    //! previous_statistics are the statistics of the generation before, or of the start population.
     virtual bool IsCorrectResult(
     		const Population& population,
-    		const ScorePopulation& score_population) const = 0;
+    		const ScorePopulation& score_population,
+    		const PopulationStatistics<Value>& previous_statistics,
+    		const PopulationStatistics<Value>& statistics) const = 0;
 
     virtual ~IGeneticAlgorithmStrategy() {};
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+
+#include "stable.h"
+#include "Random.h"
+
+namespace GA
+{
+
+//! Operators of a problem with ObjectiveCount objectives, every objective is minimized.
+template <typename Genotype, size_t ObjectiveCount>
+class IMultiObjectiveStrategy
+{
+	using Population = std::vector<Genotype>;
+
+public:
+
+	using GenotypeType = Genotype;
+	using ObjectivesType = std::array<double, ObjectiveCount>;
+
+	virtual Population CreateStartPopulation(RandomGenerator& generator) const = 0;
+
+	//! May be called concurrently for different genotypes, all randomness must come from generator.
+	virtual void MutationInPlace(
+			Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const = 0;
+
+	//! Writes the child into a slot that keeps the memory of an older genotype.
+	//! May be called concurrently for different children.
+	virtual void CrossingoverInto(
+			const Genotype& first_parent,
+			const Genotype& second_parent,
+			Genotype& child,
+			RandomGenerator& generator) const = 0;
+
+	//! Scores count genotypes into objectives.
+	virtual void ObjectivesBatch(
+			const Genotype* genotypes,
+			const size_t count,
+			ObjectivesType* objectives) const = 0;
+
+	virtual ~IMultiObjectiveStrategy() = default;
+};
+
+template <typename Genotype, size_t ObjectiveCount>
+using IMultiObjectiveStrategyPtr = std::shared_ptr<IMultiObjectiveStrategy<Genotype, ObjectiveCount>>;
+
+} // GeneticAlgorithm
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "stable.h"
+#include "PopulationStatistics.h"
+#include "Random.h"
+#include "ScratchArena.h"
 
 namespace GA
 {
@@ -8,9 +11,19 @@ namespace GA
 template <typename Value = double>
 class ISelectionFunction
 {
-    using ScorePopulation = std::vector<Value>;
 public:
-    virtual std::vector<double> Selection(const ScorePopulation& score_population) const = 0;
+	using ValueType = Value;
+
+    //! Writes a key for every one of count scores into keys, the individuals with the highest keys are replaced.
+    //! statistics are the statistics of the scores, stochastic selectors draw from generator,
+    //! temporary buffers come from arena, so a selector doesn't allocate once the arena has grown.
+    virtual void Selection(
+    		const Value* scores,
+    		const size_t count,
+    		const PopulationStatistics<Value>& statistics,
+    		RandomGenerator& generator,
+    		ScratchArena& arena,
+    		double* keys) const = 0;
 
     virtual ~ISelectionFunction() = default;
 };
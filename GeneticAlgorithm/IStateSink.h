@@ -0,0 +1,27 @@
+#pragma once
+
+#include "stable.h"
+#include "State.h"
+
+namespace GA
+{
+
+//! Receives every generation while Calculation runs.
+template <typename Genotype, typename ScoreValue>
+class IStateSink
+{
+public:
+
+	//! Called with the state at the beginning of each iteration, the state is only valid during the call.
+	virtual void Consume(const size_t iteration, const State<Genotype, ScoreValue>& state) = 0;
+
+	//! Called once after the last iteration.
+	virtual void Finish() {}
+
+	virtual ~IStateSink() = default;
+};
+
+template <typename Genotype, typename ScoreValue>
+using IStateSinkPtr = std::shared_ptr<IStateSink<Genotype, ScoreValue>>;
+
+} // GeneticAlgorithm
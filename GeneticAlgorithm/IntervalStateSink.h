@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+
+#include "stable.h"
+#include "IStateSink.h"
+
+namespace GA
+{
+
+//! Passes a generation on once generation_interval generations or time_interval have gone by
+//! since the last one it passed on, whichever comes first; a zero interval is never reached.
+//! The first generation only starts the count: it is the start population or the generation a run resumed from.
+template <typename Genotype, typename ScoreValue>
+class IntervalStateSink final : public IStateSink<Genotype, ScoreValue>
+{
+	using Clock = std::chrono::steady_clock;
+
+public:
+
+	IntervalStateSink(
+			const IStateSinkPtr<Genotype, ScoreValue>& sink,
+			const size_t generation_interval,
+			const Clock::duration time_interval = Clock::duration::zero())
+			: sink_(sink)
+			, generation_interval_(generation_interval)
+			, time_interval_(time_interval)
+	{
+		if (!sink)
+		{
+			throw std::runtime_error("Empty state sink");
+		}
+		if (generation_interval == 0 && time_interval <= Clock::duration::zero())
+		{
+			throw std::runtime_error("State sink interval must be positive");
+		}
+	}
+
+	void Consume(const size_t iteration, const State<Genotype, ScoreValue>& state) override
+	{
+		const auto now = Clock::now();
+		if (is_started_)
+		{
+			const bool is_generation_due = generation_interval_ != 0 && iteration - last_iteration_ >= generation_interval_;
+			const bool is_time_due = time_interval_ > Clock::duration::zero() && now - last_time_ >= time_interval_;
+			if (!is_generation_due && !is_time_due)
+			{
+				return;
+			}
+			sink_->Consume(iteration, state);
+		}
+
+		is_started_ = true;
+		last_iteration_ = iteration;
+		last_time_ = now;
+	}
+
+	void Finish() override
+	{
+		sink_->Finish();
+	}
+
+private:
+	IStateSinkPtr<Genotype, ScoreValue> sink_;
+	size_t generation_interval_;
+	Clock::duration time_interval_;
+
+	bool is_started_ = false;
+	size_t last_iteration_ = 0;
+	Clock::time_point last_time_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <exception>
+#include <thread>
+
+#include "stable.h"
+#include "GeneticAlgorithm.h"
+#include "MigrationTransport.h"
+
+namespace GA
+{
+
+struct MigrationOptions
+{
+	size_t interval_ = 10;
+	size_t migrant_count_ = 1;
+	MigrationTopology topology_ = MigrationTopology::Ring;
+};
+
+template <typename Genotype, typename ScoreValue>
+struct IslandGeneticAlgorithmResult
+{
+	std::vector<GeneticAlgorithmResult<Genotype, ScoreValue>> islands_;
+	size_t best_island_ = 0;
+	size_t best_index_ = 0;
+	Genotype best_genotype_{};
+	ScoreValue best_score_{};
+};
+
+//! One island of a migrating population: the usual generation loop plus an exchange of migrants
+//! every interval_ generations. The island sends copies of its migrant_count_ best individuals (lowest scores)
+//! to every outgoing channel and replaces its worst individuals with everything it has received.
+template <typename Solver>
+class MigratingIsland
+{
+	using Index = size_t;
+	using Indexes = std::vector<Index>;
+	using Genotype = typename Solver::Genotype;
+	using ScoreValue = typename Solver::ScoreValue;
+	using MigrantType = Migrant<Genotype, ScoreValue>;
+
+public:
+
+	MigratingIsland(
+			const Solver& solver,
+			IMigrationTransport<Genotype, ScoreValue>& transport,
+			const MigrationLinks& links,
+			const MigrationOptions& options)
+			: solver_(solver)
+			, transport_(transport)
+			, links_(links)
+			, options_(options)
+	{}
+
+	//! Runs until is_continue(iteration_count, is_correct_result) returns false.
+	template <typename ContinuePredicate>
+	void Run(
+			const double mutation_part,
+			const double crossingover_part,
+			const RandomStreams& streams,
+			GeneticAlgorithmResult<Genotype, ScoreValue>& result,
+			ContinuePredicate&& is_continue)
+	{
+		result.seed_ = streams.Seed();
+
+		typename Solver::Workspace workspace;
+		solver_.Initialize(streams, result.final_state_, workspace);
+
+		bool is_correct_result;
+		do
+		{
+			solver_.Step(mutation_part, crossingover_part, result.iteration_count_, streams, result.final_state_, workspace);
+			result.iteration_count_++;
+
+			if (result.iteration_count_ % options_.interval_ == 0)
+			{
+				SendMigrants(result.final_state_);
+				if (ReceiveMigrants(result.final_state_))
+				{
+					solver_.UpdateStatistics(result.final_state_, workspace);
+				}
+			}
+
+			is_correct_result = solver_.IsCorrectResult(result.final_state_, workspace);
+		}
+		while (is_continue(result.iteration_count_, is_correct_result));
+	}
+
+private:
+
+	void SendMigrants(const State<Genotype, ScoreValue>& state)
+	{
+		const auto& scores = state.current_population_score_;
+		const size_t migrant_count = std::min(options_.migrant_count_, scores.size());
+		if (links_.outgoing_.empty() || migrant_count == 0)
+		{
+			return;
+		}
+
+		order_.resize(scores.size());
+		std::iota(order_.begin(), order_.end(), Index{0});
+		std::nth_element(order_.begin(), order_.begin() + migrant_count - 1, order_.end(),
+				[&scores](const Index left, const Index right) { return scores[left] < scores[right]; });
+
+		for (const size_t channel : links_.outgoing_)
+		{
+			for (size_t position = 0; position < migrant_count; ++position)
+			{
+				const Index index = order_[position];
+				transport_.TrySend(channel, MigrantType{state.current_population_[index], scores[index]});
+			}
+		}
+	}
+
+	//! Returns false when nothing has arrived.
+	bool ReceiveMigrants(State<Genotype, ScoreValue>& state)
+	{
+		migrants_.clear();
+		MigrantType migrant;
+		for (const size_t channel : links_.incoming_)
+		{
+			while (transport_.TryReceive(channel, migrant))
+			{
+				migrants_.push_back(migrant);
+			}
+		}
+
+		auto& scores = state.current_population_score_;
+		const size_t replaced_count = std::min(migrants_.size(), scores.size());
+		if (replaced_count == 0)
+		{
+			return false;
+		}
+
+		order_.resize(scores.size());
+		std::iota(order_.begin(), order_.end(), Index{0});
+		std::nth_element(order_.begin(), order_.begin() + replaced_count - 1, order_.end(),
+				[&scores](const Index left, const Index right) { return scores[left] > scores[right]; });
+
+		for (size_t position = 0; position < replaced_count; ++position)
+		{
+			const Index index = order_[position];
+			state.current_population_[index] = migrants_[position].genotype_;
+			scores[index] = migrants_[position].score_;
+		}
+		return true;
+	}
+
+	const Solver& solver_;
+	IMigrationTransport<Genotype, ScoreValue>& transport_;
+	const MigrationLinks& links_;
+	const MigrationOptions& options_;
+
+	Indexes order_;
+	std::vector<MigrantType> migrants_;
+};
+
+//! Fills the best individual (lowest score) across all islands, islands without population are skipped.
+template <typename Genotype, typename ScoreValue>
+void FindBestIsland(IslandGeneticAlgorithmResult<Genotype, ScoreValue>& result)
+{
+	bool is_found = false;
+	for (size_t island = 0; island < result.islands_.size(); ++island)
+	{
+		const auto& state = result.islands_[island].final_state_;
+		const auto& scores = state.current_population_score_;
+		if (scores.empty())
+		{
+			continue;
+		}
+
+		const size_t index = std::min_element(scores.begin(), scores.end()) - scores.begin();
+		if (!is_found || scores[index] < result.best_score_)
+		{
+			is_found = true;
+			result.best_island_ = island;
+			result.best_index_ = index;
+			result.best_score_ = scores[index];
+			result.best_genotype_ = state.current_population_[index];
+		}
+	}
+
+	if (!is_found)
+	{
+		throw std::runtime_error("No island has produced a population");
+	}
+}
+
+//! Runs every island solver on its own thread over its own subpopulation.
+//! Migrants travel through lock-free single producer single consumer queues, a full queue drops migrants,
+//! so islands never wait for each other and the exchange depends on thread timing.
+template <typename Strategy, typename Selector>
+class IslandGeneticAlgorithm
+{
+public:
+
+	using Solver = BasicGeneticAlgorithm<Strategy, Selector>;
+	using SolverPtr = std::shared_ptr<Solver>;
+	using Genotype = typename Solver::Genotype;
+	using ScoreValue = typename Solver::ScoreValue;
+
+	//! Islands must not share strategy objects that keep state between calls.
+	IslandGeneticAlgorithm(const std::vector<SolverPtr>& islands, const MigrationOptions& options)
+			: islands_(islands)
+			, options_(options)
+	{
+		if (islands_.empty())
+		{
+			throw std::runtime_error("Island model needs at least one island");
+		}
+		if (std::find(islands_.begin(), islands_.end(), nullptr) != islands_.end())
+		{
+			throw std::runtime_error("Empty island solver");
+		}
+		if (options_.interval_ == 0)
+		{
+			throw std::runtime_error("Migration interval must be positive");
+		}
+	}
+
+	size_t IslandCount() const
+	{
+		return islands_.size();
+	}
+
+	IslandGeneticAlgorithmResult<Genotype, ScoreValue> Calculation(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit = 1000,
+			const uint64_t seed = std::random_device{}()) const
+	{
+		const size_t island_count = islands_.size();
+
+		size_t channel_count;
+		const auto& links = MakeMigrationLinks(island_count, options_.topology_, channel_count);
+		LoopbackMigrationTransport<Genotype, ScoreValue> transport(
+				channel_count, std::max<size_t>(1, channel_capacity_factor_ * options_.migrant_count_));
+
+		IslandGeneticAlgorithmResult<Genotype, ScoreValue> result;
+		result.islands_.resize(island_count);
+
+		const RandomStreams streams(seed);
+		std::vector<std::exception_ptr> errors(island_count);
+		std::vector<std::thread> threads;
+		threads.reserve(island_count);
+		for (size_t island = 0; island < island_count; ++island)
+		{
+			threads.emplace_back(
+					[&, island]()
+					{
+						try
+						{
+							MigratingIsland<Solver> migrating_island(*islands_[island], transport, links[island], options_);
+							migrating_island.Run(mutation_part, crossingover_part, streams.Derive(island),
+									result.islands_[island],
+									[limit](const size_t iteration_count, const bool is_correct_result)
+									{
+										return !is_correct_result && iteration_count < limit;
+									});
+						}
+						catch (...)
+						{
+							errors[island] = std::current_exception();
+						}
+					});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (const auto& error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+
+		FindBestIsland(result);
+		return result;
+	}
+
+private:
+
+	constexpr static size_t channel_capacity_factor_ = 4;
+
+	std::vector<SolverPtr> islands_;
+	MigrationOptions options_;
+};
+
+template <typename Strategy, typename Selector>
+using IslandGeneticAlgorithmPtr = std::shared_ptr<IslandGeneticAlgorithm<Strategy, Selector>>;
+
+} // GeneticAlgorithm
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+
+#include "stable.h"
+#include "GenotypeFeatures.h"
+
+namespace GA
+{
+
+struct SurrogateStatistics
+{
+	uint64_t evaluated_count_ = 0;
+	uint64_t skipped_count_ = 0;
+	//! Evaluated genotypes that had a prediction, the error is measured on them.
+	uint64_t predicted_count_ = 0;
+	double absolute_error_sum_ = 0.0;
+
+	double SkippedPart() const
+	{
+		const uint64_t count = evaluated_count_ + skipped_count_;
+		return count == 0 ? 0.0 : static_cast<double>(skipped_count_) / static_cast<double>(count);
+	}
+
+	double MeanAbsoluteError() const
+	{
+		return predicted_count_ == 0 ? 0.0 : absolute_error_sum_ / static_cast<double>(predicted_count_);
+	}
+};
+
+//! Predicts scores by k nearest neighbours among the latest evaluated genotypes,
+//! weighted by the inverse squared distance in the coordinates of GenotypeFeatures.
+//! Add collects evaluations from any number of threads, Train moves them into the model and rebuilds
+//! its k-d tree. The collected evaluations are ordered by score before they are kept, so the model
+//! doesn't depend on the order in which threads added them. Predict may run concurrently with Add,
+//! Train waits for the running predictions.
+template <typename Genotype, typename Value, typename Features = GenotypeFeatures<Genotype>>
+class KnnSurrogate
+{
+	using Point = std::array<double, Features::count_>;
+	using Neighbour = std::pair<double, uint32_t>;
+
+public:
+
+	//! Buffer of the nearest neighbours of a prediction, the caller keeps it to reuse its memory.
+	using Neighbours = std::vector<Neighbour>;
+
+	explicit KnnSurrogate(const size_t neighbour_count = 8, const size_t capacity = 4096)
+			: neighbour_count_(neighbour_count)
+			, capacity_(capacity)
+	{
+		if (neighbour_count == 0)
+		{
+			throw std::runtime_error("Surrogate needs at least one neighbour");
+		}
+		if (capacity < neighbour_count || capacity > std::numeric_limits<uint32_t>::max())
+		{
+			throw std::runtime_error("Surrogate capacity must hold the neighbours");
+		}
+	}
+
+	KnnSurrogate(const KnnSurrogate&) = delete;
+	KnnSurrogate& operator=(const KnnSurrogate&) = delete;
+
+	//! false while the model has fewer samples than neighbours, predictions are left untouched then.
+	bool Predict(const Genotype* genotypes, const size_t count, Value* predictions, Neighbours& neighbours) const
+	{
+		std::shared_lock<std::shared_mutex> lock(model_mutex_);
+		if (tree_.size() < neighbour_count_)
+		{
+			return false;
+		}
+
+		neighbours.reserve(neighbour_count_);
+		for (size_t index = 0; index < count; ++index)
+		{
+			Point point;
+			Features::Extract(genotypes[index], point.data());
+
+			neighbours.clear();
+			Search(point, 0, tree_.size(), 0, neighbours);
+			std::sort_heap(neighbours.begin(), neighbours.end());
+			predictions[index] = Interpolate(neighbours);
+		}
+		return true;
+	}
+
+	void Add(const Genotype* genotypes, const Value* scores, const size_t count)
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex_);
+		for (size_t index = 0; index < count; ++index)
+		{
+			Point point;
+			Features::Extract(genotypes[index], point.data());
+			pending_.emplace_back(scores[index], point);
+		}
+	}
+
+	//! The best capacity of the collected evaluations take the place of the oldest samples.
+	void Train()
+	{
+		std::unique_lock<std::shared_mutex> model_lock(model_mutex_);
+		std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+		if (pending_.empty())
+		{
+			return;
+		}
+
+		std::sort(pending_.begin(), pending_.end());
+		const size_t count = std::min(pending_.size(), capacity_);
+		for (size_t position = 0; position < count; ++position)
+		{
+			if (points_.size() < capacity_)
+			{
+				points_.push_back(pending_[position].second);
+				values_.push_back(pending_[position].first);
+			}
+			else
+			{
+				points_[next_sample_] = pending_[position].second;
+				values_[next_sample_] = pending_[position].first;
+			}
+			next_sample_ = (next_sample_ + 1) % capacity_;
+		}
+		pending_.clear();
+
+		tree_.resize(points_.size());
+		std::iota(tree_.begin(), tree_.end(), uint32_t{0});
+		Build(0, tree_.size(), 0);
+	}
+
+	void Record(const SurrogateStatistics& statistics)
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex_);
+		statistics_.evaluated_count_ += statistics.evaluated_count_;
+		statistics_.skipped_count_ += statistics.skipped_count_;
+		statistics_.predicted_count_ += statistics.predicted_count_;
+		statistics_.absolute_error_sum_ += statistics.absolute_error_sum_;
+	}
+
+	SurrogateStatistics Statistics() const
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex_);
+		return statistics_;
+	}
+
+private:
+
+	//! The node of [begin, end) is its middle, split by the coordinate depth modulo the feature count.
+	void Build(const size_t begin, const size_t end, const size_t depth)
+	{
+		if (end - begin <= 1)
+		{
+			return;
+		}
+
+		const size_t middle = (begin + end) / 2;
+		const size_t axis = depth % feature_count_;
+		std::nth_element(tree_.begin() + begin, tree_.begin() + middle, tree_.begin() + end,
+				[this, axis](const uint32_t left, const uint32_t right)
+				{
+					return points_[left][axis] < points_[right][axis]
+							|| (points_[left][axis] == points_[right][axis] && left < right);
+				});
+		Build(begin, middle, depth + 1);
+		Build(middle + 1, end, depth + 1);
+	}
+
+	//! neighbours is a max-heap by distance, then by sample, of at most neighbour_count_ samples.
+	void Search(
+			const Point& point,
+			const size_t begin,
+			const size_t end,
+			const size_t depth,
+			Neighbours& neighbours) const
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		const size_t middle = (begin + end) / 2;
+		const uint32_t sample = tree_[middle];
+		Offer(Neighbour(SquaredDistance(point, points_[sample]), sample), neighbours);
+
+		const size_t axis = depth % feature_count_;
+		const double delta = point[axis] - points_[sample][axis];
+		if (delta < 0.0)
+		{
+			Search(point, begin, middle, depth + 1, neighbours);
+			if (neighbours.size() < neighbour_count_ || delta * delta <= neighbours.front().first)
+			{
+				Search(point, middle + 1, end, depth + 1, neighbours);
+			}
+		}
+		else
+		{
+			Search(point, middle + 1, end, depth + 1, neighbours);
+			if (neighbours.size() < neighbour_count_ || delta * delta <= neighbours.front().first)
+			{
+				Search(point, begin, middle, depth + 1, neighbours);
+			}
+		}
+	}
+
+	void Offer(const Neighbour& neighbour, Neighbours& neighbours) const
+	{
+		if (neighbours.size() < neighbour_count_)
+		{
+			neighbours.push_back(neighbour);
+			std::push_heap(neighbours.begin(), neighbours.end());
+		}
+		else if (neighbour < neighbours.front())
+		{
+			std::pop_heap(neighbours.begin(), neighbours.end());
+			neighbours.back() = neighbour;
+			std::push_heap(neighbours.begin(), neighbours.end());
+		}
+	}
+
+	//! neighbours are sorted by distance, a sample at the point itself gives its value.
+	Value Interpolate(const Neighbours& neighbours) const
+	{
+		if (neighbours.front().first == 0.0)
+		{
+			return values_[neighbours.front().second];
+		}
+
+		double weighted_sum = 0.0;
+		double weight_sum = 0.0;
+		for (const auto& neighbour : neighbours)
+		{
+			const double weight = 1.0 / neighbour.first;
+			weighted_sum += weight * static_cast<double>(values_[neighbour.second]);
+			weight_sum += weight;
+		}
+		return static_cast<Value>(weighted_sum / weight_sum);
+	}
+
+	static double SquaredDistance(const Point& first, const Point& second)
+	{
+		double distance = 0.0;
+		for (size_t axis = 0; axis < feature_count_; ++axis)
+		{
+			const double delta = first[axis] - second[axis];
+			distance += delta * delta;
+		}
+		return distance;
+	}
+
+	size_t neighbour_count_;
+	size_t capacity_;
+
+	mutable std::shared_mutex model_mutex_;
+	std::vector<Point> points_;
+	std::vector<Value> values_;
+	size_t next_sample_ = 0;
+	std::vector<uint32_t> tree_;
+
+	mutable std::mutex pending_mutex_;
+	std::vector<std::pair<Value, Point>> pending_;
+	SurrogateStatistics statistics_;
+
+	constexpr static size_t feature_count_ = Features::count_;
+};
+
+template <typename Genotype, typename Value>
+using KnnSurrogatePtr = std::shared_ptr<KnnSurrogate<Genotype, Value>>;
+
+} // GeneticAlgorithm
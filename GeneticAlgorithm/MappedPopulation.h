@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Population file: MappedPopulationFileHeader, then population_size_ genotypes from genotype_offset_
+//! and population_size_ scores from score_offset_, both offsets are multiples of the page size.
+struct MappedPopulationFileHeader
+{
+	char magic_[8];
+	uint32_t version_;
+	uint32_t header_size_;
+	uint64_t genotype_size_;
+	uint64_t value_size_;
+	uint64_t population_size_;
+	uint64_t genotype_offset_;
+	uint64_t score_offset_;
+	uint64_t reserved_[1];
+};
+
+static_assert(sizeof(MappedPopulationFileHeader) == 64, "Population file header must stay 64 bytes");
+
+//! Genotypes and scores of a population that doesn't have to fit in memory, mapped from a file.
+//! Pages are read when they are touched and written back by the kernel, so the resident part is what
+//! the engine touched lately. Prefetch asks for the pages of a range before a pass reaches it,
+//! Release starts writing a range back after the pass and marks its pages as the first ones to reclaim.
+//! The file keeps raw bytes, so it needs trivially copyable genotypes and values.
+template <typename Genotype, typename Value>
+class MappedPopulation
+{
+	static_assert(std::is_trivially_copyable_v<Genotype> && std::is_trivially_copyable_v<Value>,
+			"Population file holds raw bytes of genotypes and scores");
+
+public:
+
+	//! Creates file_name with room for size genotypes and scores, the file is sparse until written.
+	//! An existing file is replaced only when is_overwriting is set, otherwise it is an error.
+	MappedPopulation(const std::string& file_name, const size_t size, const bool is_overwriting = false)
+			: file_name_(file_name)
+			, population_size_(size)
+	{
+		if (size == 0)
+		{
+			throw std::runtime_error("Population file needs at least one individual");
+		}
+
+		page_size_ = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+		genotype_offset_ = page_size_;
+		score_offset_ = RoundUp(genotype_offset_ + size * sizeof(Genotype), page_size_);
+		size_ = RoundUp(score_offset_ + size * sizeof(Value), page_size_);
+
+		// A file this call created is removed again when it can't be set up, so a retry doesn't find it
+		descriptor_ = ::open(file_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+		const bool is_created = descriptor_ >= 0;
+		if (!is_created && errno == EEXIST && is_overwriting)
+		{
+			descriptor_ = ::open(file_name_.c_str(), O_RDWR | O_TRUNC);
+		}
+		else if (!is_created && errno == EEXIST)
+		{
+			throw std::runtime_error("Population file already exists: " + file_name_);
+		}
+		if (descriptor_ < 0)
+		{
+			throw std::runtime_error("Can't create population file: " + file_name_);
+		}
+		if (::ftruncate(descriptor_, static_cast<off_t>(size_)) != 0)
+		{
+			CloseAfterFailure(is_created);
+			throw std::runtime_error("Can't resize population file: " + file_name_);
+		}
+
+		void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_, 0);
+		if (data == MAP_FAILED)
+		{
+			CloseAfterFailure(is_created);
+			throw std::runtime_error("Can't map population file: " + file_name_);
+		}
+		data_ = static_cast<unsigned char*>(data);
+		::madvise(data_, size_, MADV_SEQUENTIAL);
+
+		MappedPopulationFileHeader header{};
+		std::memcpy(header.magic_, file_magic_, sizeof(header.magic_));
+		header.version_ = file_version_;
+		header.header_size_ = sizeof(MappedPopulationFileHeader);
+		header.genotype_size_ = sizeof(Genotype);
+		header.value_size_ = sizeof(Value);
+		header.population_size_ = size;
+		header.genotype_offset_ = genotype_offset_;
+		header.score_offset_ = score_offset_;
+		std::memcpy(data_, &header, sizeof(header));
+	}
+
+	MappedPopulation(const MappedPopulation&) = delete;
+	MappedPopulation& operator=(const MappedPopulation&) = delete;
+
+	size_t Size() const
+	{
+		return population_size_;
+	}
+
+	const std::string& FileName() const
+	{
+		return file_name_;
+	}
+
+	Genotype* Genotypes() const
+	{
+		return reinterpret_cast<Genotype*>(data_ + genotype_offset_);
+	}
+
+	Value* Scores() const
+	{
+		return reinterpret_cast<Value*>(data_ + score_offset_);
+	}
+
+	//! Reads [begin, end) ahead in the background, the call doesn't wait for the disk.
+	void Prefetch(const size_t begin, const size_t end) const
+	{
+		Advise(genotype_offset_ + begin * sizeof(Genotype), (end - begin) * sizeof(Genotype), MADV_WILLNEED);
+		Advise(score_offset_ + begin * sizeof(Value), (end - begin) * sizeof(Value), MADV_WILLNEED);
+	}
+
+	//! Starts writing [begin, end) back without waiting for it, then lets the kernel reclaim its pages first,
+	//! so a pass over the population doesn't push the rest of the system out of memory.
+	void Release(const size_t begin, const size_t end) const
+	{
+		WriteBack(genotype_offset_ + begin * sizeof(Genotype), (end - begin) * sizeof(Genotype));
+		WriteBack(score_offset_ + begin * sizeof(Value), (end - begin) * sizeof(Value));
+#if defined(MADV_COLD)
+		Advise(genotype_offset_ + begin * sizeof(Genotype), (end - begin) * sizeof(Genotype), MADV_COLD);
+		Advise(score_offset_ + begin * sizeof(Value), (end - begin) * sizeof(Value), MADV_COLD);
+#endif
+	}
+
+	//! Waits until the whole file is written.
+	void Flush() const
+	{
+		if (::msync(data_, size_, MS_SYNC) != 0)
+		{
+			throw std::runtime_error("Can't write population file: " + file_name_);
+		}
+	}
+
+	~MappedPopulation()
+	{
+		::munmap(data_, size_);
+		::close(descriptor_);
+	}
+
+private:
+
+	static size_t RoundUp(const size_t value, const size_t step)
+	{
+		return (value + step - 1) / step * step;
+	}
+
+	void CloseAfterFailure(const bool is_created) const
+	{
+		::close(descriptor_);
+		if (is_created)
+		{
+			::unlink(file_name_.c_str());
+		}
+	}
+
+	//! Advice is a hint, the range is widened to whole pages and failures are ignored.
+	void Advise(const size_t offset, const size_t size, const int advice) const
+	{
+		const size_t begin = offset / page_size_ * page_size_;
+		::madvise(data_ + begin, RoundUp(offset + size, page_size_) - begin, advice);
+	}
+
+	void WriteBack(const size_t offset, const size_t size) const
+	{
+#if defined(__linux__)
+		::sync_file_range(descriptor_, static_cast<off_t>(offset), static_cast<off_t>(size), SYNC_FILE_RANGE_WRITE);
+#else
+		static_cast<void>(offset);
+		static_cast<void>(size);
+#endif
+	}
+
+	std::string file_name_;
+	size_t population_size_;
+	size_t page_size_ = 0;
+	size_t genotype_offset_ = 0;
+	size_t score_offset_ = 0;
+	size_t size_ = 0;
+	int descriptor_ = -1;
+	unsigned char* data_ = nullptr;
+
+	constexpr static char file_magic_[8] = {'G', 'A', 'P', 'O', 'P', 'U', 'L', '1'};
+	constexpr static uint32_t file_version_ = 1;
+};
+
+template <typename Genotype, typename Value>
+using MappedPopulationPtr = std::shared_ptr<MappedPopulation<Genotype, Value>>;
+
+} // GeneticAlgorithm
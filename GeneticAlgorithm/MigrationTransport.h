@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+#include "stable.h"
+#include "SharedMemoryRegion.h"
+#include "SpscQueue.h"
+
+namespace GA
+{
+
+enum class MigrationTopology
+{
+	Ring,
+	FullyConnected,
+};
+
+template <typename Genotype, typename ScoreValue>
+struct Migrant
+{
+	Genotype genotype_{};
+	ScoreValue score_{};
+};
+
+//! Channels of one island: indices of the directed channels it sends to and receives from.
+struct MigrationLinks
+{
+	std::vector<size_t> outgoing_;
+	std::vector<size_t> incoming_;
+};
+
+//! Numbers the directed channels of the topology, returns the links of every island.
+inline std::vector<MigrationLinks> MakeMigrationLinks(
+		const size_t island_count,
+		const MigrationTopology topology,
+		size_t& channel_count)
+{
+	std::vector<MigrationLinks> links(island_count);
+	channel_count = 0;
+
+	const auto connect = [&links, &channel_count](const size_t from, const size_t to)
+	{
+		links[from].outgoing_.push_back(channel_count);
+		links[to].incoming_.push_back(channel_count);
+		++channel_count;
+	};
+
+	if (island_count < 2)
+	{
+		return links;
+	}
+
+	for (size_t from = 0; from < island_count; ++from)
+	{
+		if (topology == MigrationTopology::Ring)
+		{
+			connect(from, (from + 1) % island_count);
+			continue;
+		}
+		for (size_t to = 0; to < island_count; ++to)
+		{
+			if (to != from)
+			{
+				connect(from, to);
+			}
+		}
+	}
+	return links;
+}
+
+//! Moves migrants between islands, every channel has one sending and one receiving island.
+//! Both calls never block: a full channel drops the migrant, an empty one returns false.
+template <typename Genotype, typename ScoreValue>
+class IMigrationTransport
+{
+public:
+
+	virtual bool TrySend(const size_t channel, const Migrant<Genotype, ScoreValue>& migrant) = 0;
+
+	virtual bool TryReceive(const size_t channel, Migrant<Genotype, ScoreValue>& migrant) = 0;
+
+	virtual ~IMigrationTransport() = default;
+};
+
+//! Transport between threads of one process.
+template <typename Genotype, typename ScoreValue>
+class LoopbackMigrationTransport final : public IMigrationTransport<Genotype, ScoreValue>
+{
+	using Channel = SpscQueue<Migrant<Genotype, ScoreValue>>;
+
+public:
+
+	LoopbackMigrationTransport(const size_t channel_count, const size_t channel_capacity)
+	{
+		channels_.reserve(channel_count);
+		for (size_t channel = 0; channel < channel_count; ++channel)
+		{
+			channels_.push_back(std::make_unique<Channel>(channel_capacity));
+		}
+	}
+
+	bool TrySend(const size_t channel, const Migrant<Genotype, ScoreValue>& migrant) override
+	{
+		return channels_[channel]->TryPush(migrant);
+	}
+
+	bool TryReceive(const size_t channel, Migrant<Genotype, ScoreValue>& migrant) override
+	{
+		return channels_[channel]->TryPop(migrant);
+	}
+
+private:
+	std::vector<std::unique_ptr<Channel>> channels_;
+};
+
+//! Transport between processes forked after it is created.
+//! Every channel is a single producer single consumer ring in a shared memory region,
+//! so Genotype and ScoreValue are copied byte by byte and must be trivially copyable.
+template <typename Genotype, typename ScoreValue>
+class SharedMemoryMigrationTransport final : public IMigrationTransport<Genotype, ScoreValue>
+{
+	using MigrantType = Migrant<Genotype, ScoreValue>;
+
+	static_assert(std::is_trivially_copyable_v<MigrantType>, "Shared memory migrants must be trivially copyable");
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory channels need lock-free atomics");
+
+	struct alignas(64) Cursor
+	{
+		std::atomic<uint64_t> position_;
+	};
+
+	struct ChannelHeader
+	{
+		Cursor head_;
+		Cursor tail_;
+	};
+
+public:
+
+	SharedMemoryMigrationTransport(const size_t channel_count, const size_t channel_capacity)
+			: channel_count_(channel_count)
+			, slot_count_(channel_capacity + 1)
+			, region_(std::max<size_t>(1, channel_count * (sizeof(ChannelHeader) + slot_count_ * sizeof(MigrantType))))
+	{
+		headers_ = static_cast<ChannelHeader*>(region_.Data());
+		slots_ = reinterpret_cast<MigrantType*>(headers_ + channel_count_);
+
+		for (size_t channel = 0; channel < channel_count_; ++channel)
+		{
+			auto* header = new (headers_ + channel) ChannelHeader;
+			header->head_.position_.store(0, std::memory_order_relaxed);
+			header->tail_.position_.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	bool TrySend(const size_t channel, const MigrantType& migrant) override
+	{
+		assert(channel < channel_count_);
+		ChannelHeader& header = headers_[channel];
+
+		const uint64_t tail = header.tail_.position_.load(std::memory_order_relaxed);
+		const uint64_t next_tail = Next(tail);
+		if (next_tail == header.head_.position_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		std::memcpy(static_cast<void*>(Slot(channel, tail)), &migrant, sizeof(MigrantType));
+		header.tail_.position_.store(next_tail, std::memory_order_release);
+		return true;
+	}
+
+	bool TryReceive(const size_t channel, MigrantType& migrant) override
+	{
+		assert(channel < channel_count_);
+		ChannelHeader& header = headers_[channel];
+
+		const uint64_t head = header.head_.position_.load(std::memory_order_relaxed);
+		if (head == header.tail_.position_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		std::memcpy(static_cast<void*>(&migrant), Slot(channel, head), sizeof(MigrantType));
+		header.head_.position_.store(Next(head), std::memory_order_release);
+		return true;
+	}
+
+private:
+
+	uint64_t Next(const uint64_t position) const
+	{
+		return position + 1 == slot_count_ ? 0 : position + 1;
+	}
+
+	MigrantType* Slot(const size_t channel, const uint64_t position) const
+	{
+		return slots_ + channel * slot_count_ + position;
+	}
+
+	size_t channel_count_;
+	size_t slot_count_;
+	SharedMemoryRegion region_;
+	ChannelHeader* headers_;
+	MigrantType* slots_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <chrono>
+#include <limits>
+
+#include "stable.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "IMultiObjectiveStrategy.h"
+#include "NonDominatedSort.h"
+
+namespace GA
+{
+
+template <typename Genotype, typename Objectives>
+struct MultiObjectiveResult
+{
+	Population<Genotype> population_;
+	std::vector<Objectives> objectives_;
+	std::vector<uint32_t> ranks_;
+	std::vector<double> crowding_distances_;
+	//! Indexes of the population with rank 0.
+	std::vector<size_t> pareto_front_;
+	size_t iteration_count_ = 0;
+	uint64_t seed_ = 0;
+	std::optional<long> times_ = std::nullopt;
+};
+
+//! NSGA-II (Deb et al., "A Fast and Elitist Multiobjective Genetic Algorithm: NSGA-II").
+//! Every generation makes as many children as there are parents, sorts parents and children together
+//! into non-dominated fronts and keeps the best fronts; the front that doesn't fit whole
+//! is cut by crowding distance, the most isolated individuals stay.
+//! Parents are picked by a binary tournament: the lower rank wins, then the larger crowding distance.
+//! A child is the crossingover of the parents with probability crossingover_part and a copy of the first one
+//! otherwise; copies are always mutated, crossingover children with probability mutation_part.
+//! Every child has its own random stream, so a seed gives one result for any thread count.
+template <typename Strategy>
+class MultiObjectiveGeneticAlgorithm
+{
+public:
+
+	using StrategyType = Strategy;
+	using Genotype = typename Strategy::GenotypeType;
+	using Objectives = typename Strategy::ObjectivesType;
+
+	explicit MultiObjectiveGeneticAlgorithm(const std::shared_ptr<Strategy>& strategy, const size_t thread_count = 1)
+			: strategy_(strategy)
+	{
+		if (!strategy)
+		{
+			throw std::runtime_error("Empty strategy");
+		}
+		if (thread_count == 0)
+		{
+			throw std::runtime_error("Thread count must be positive");
+		}
+		if (thread_count > 1)
+		{
+			thread_pool_ = std::make_shared<ThreadPool>(thread_count);
+		}
+	}
+
+	size_t ThreadCount() const
+	{
+		return thread_pool_ ? thread_pool_->ThreadCount() : 1;
+	}
+
+	//! Runs limit generations, there is no convergence check.
+	template <bool IsMeasuringTime = false>
+	MultiObjectiveResult<Genotype, Objectives> Calculation(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit = 1000,
+			const uint64_t seed = std::random_device{}()) const
+	{
+		std::chrono::steady_clock::time_point start_time;
+		if constexpr (IsMeasuringTime)
+		{
+			start_time = std::chrono::steady_clock::now();
+		}
+
+		const RandomStreams streams(seed);
+		Workspace workspace;
+		const size_t population_size = Initialize(streams, workspace);
+
+		size_t iteration_count = 0;
+		for (; iteration_count < limit; ++iteration_count)
+		{
+			MakeChildren(mutation_part, crossingover_part, iteration_count, streams, workspace);
+			Rank(2 * population_size, population_size, workspace);
+			SelectSurvivors(population_size, workspace);
+			GatherSurvivors(workspace);
+		}
+
+		MultiObjectiveResult<Genotype, Objectives> result;
+		result.seed_ = seed;
+		result.iteration_count_ = iteration_count;
+
+		workspace.population_.resize(population_size);
+		workspace.objectives_.resize(population_size);
+		result.population_ = std::move(workspace.population_);
+		result.objectives_ = std::move(workspace.objectives_);
+		result.ranks_.assign(workspace.ranks_.begin(), workspace.ranks_.begin() + population_size);
+		result.crowding_distances_.assign(
+				workspace.crowding_distances_.begin(), workspace.crowding_distances_.begin() + population_size);
+		for (size_t index = 0; index < population_size; ++index)
+		{
+			if (result.ranks_[index] == 0)
+			{
+				result.pareto_front_.push_back(index);
+			}
+		}
+
+		if constexpr (IsMeasuringTime)
+		{
+			result.times_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_time).count();
+		}
+		return result;
+	}
+
+private:
+
+	//! Parents take [0, N) and children [N, 2N) of every buffer; ranks and crowding distances
+	//! of the parents are the ones they got when they were selected.
+	//! Survivors are gathered into the next_ buffers, which then take the place of the current ones.
+	struct Workspace
+	{
+		Population<Genotype> population_;
+		std::vector<Objectives> objectives_;
+		std::vector<uint32_t> ranks_;
+		std::vector<double> crowding_distances_;
+
+		Population<Genotype> next_population_;
+		std::vector<Objectives> next_objectives_;
+		std::vector<uint32_t> next_ranks_;
+		std::vector<double> next_crowding_distances_;
+
+		NonDominatedSorter<Objectives> sorter_;
+		//! Fronts that are kept whole or cut, only they need crowding distances.
+		size_t ranked_front_count_ = 0;
+		//! Members of the ranked fronts sorted by every objective in turn, objective by objective.
+		std::vector<uint32_t> objective_orders_;
+		//! Crowding distance parts, objective by objective.
+		std::vector<double> distance_parts_;
+		std::vector<uint32_t> survivors_;
+	};
+
+	size_t Initialize(const RandomStreams& streams, Workspace& workspace) const
+	{
+		auto start_generator = streams.Stream(RandomStreamPurpose::StartPopulation, 0, 0);
+		auto start_population = strategy_->CreateStartPopulation(start_generator);
+
+		const size_t population_size = start_population.size();
+		if (population_size == 0 || population_size > std::numeric_limits<uint32_t>::max() / 2)
+		{
+			throw std::runtime_error("Multi-objective engine needs from 1 to 2^31 - 1 individuals");
+		}
+
+		// Child slots start as copies of a real genotype, so genotypes that own memory get it once
+		auto& population = workspace.population_;
+		population = std::move(start_population);
+		population.resize(2 * population_size, population.front());
+		workspace.objectives_.resize(2 * population_size);
+		workspace.ranks_.resize(2 * population_size);
+		workspace.crowding_distances_.resize(2 * population_size);
+
+		workspace.next_population_ = population;
+		workspace.next_objectives_.resize(2 * population_size);
+		workspace.next_ranks_.resize(2 * population_size);
+		workspace.next_crowding_distances_.resize(2 * population_size);
+		workspace.survivors_.reserve(population_size);
+
+		ParallelFor(population_size, chunk_size_,
+				[this, &workspace](const size_t begin, const size_t end)
+				{
+					strategy_->ObjectivesBatch(
+							workspace.population_.data() + begin, end - begin, workspace.objectives_.data() + begin);
+				});
+
+		Rank(population_size, population_size, workspace);
+		const auto& ranks = workspace.sorter_.Ranks();
+		std::copy(ranks.begin(), ranks.end(), workspace.ranks_.begin());
+		return population_size;
+	}
+
+	void MakeChildren(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t iteration_count,
+			const RandomStreams& streams,
+			Workspace& workspace) const
+	{
+		const size_t population_size = workspace.population_.size() / 2;
+		ParallelFor(population_size, chunk_size_,
+				[&](const size_t begin, const size_t end)
+				{
+					auto& population = workspace.population_;
+					for (size_t child = begin; child < end; ++child)
+					{
+						auto generator = streams.Stream(RandomStreamPurpose::Offspring, iteration_count, child);
+						Genotype& slot = population[population_size + child];
+
+						const uint32_t first = Tournament(workspace, population_size, generator);
+						const bool is_crossingover = UniformUnit(generator) < crossingover_part;
+						if (is_crossingover)
+						{
+							const uint32_t second = Tournament(workspace, population_size, generator);
+							strategy_->CrossingoverInto(population[first], population[second], slot, generator);
+						}
+						else
+						{
+							slot = population[first];
+						}
+						if (!is_crossingover || UniformUnit(generator) < mutation_part)
+						{
+							strategy_->MutationInPlace(slot, iteration_count, generator);
+						}
+					}
+
+					strategy_->ObjectivesBatch(
+							population.data() + population_size + begin,
+							end - begin,
+							workspace.objectives_.data() + population_size + begin);
+				});
+	}
+
+	//! Binary tournament with replacement, the earlier one wins a tie.
+	static uint32_t Tournament(const Workspace& workspace, const size_t population_size, RandomGenerator& generator)
+	{
+		const uint32_t size = static_cast<uint32_t>(population_size);
+		const uint32_t first = UniformIndex(generator, size);
+		const uint32_t second = UniformIndex(generator, size);
+		return IsCrowdedBetter(workspace, second, first) ? second : first;
+	}
+
+	static bool IsCrowdedBetter(const Workspace& workspace, const uint32_t first, const uint32_t second)
+	{
+		const auto& ranks = workspace.ranks_;
+		const auto& distances = workspace.crowding_distances_;
+		return ranks[first] < ranks[second]
+				|| (ranks[first] == ranks[second] && distances[first] > distances[second]);
+	}
+
+	//! Sorts the first count individuals into fronts and computes crowding distances for the fronts
+	//! needed to fill kept_count places.
+	void Rank(const size_t count, const size_t kept_count, Workspace& workspace) const
+	{
+		auto& sorter = workspace.sorter_;
+		sorter.Sort(workspace.objectives_.data(), count);
+
+		size_t front_count = 0;
+		while (front_count < sorter.FrontCount() && sorter.FrontBegin(front_count) < kept_count)
+		{
+			++front_count;
+		}
+		workspace.ranked_front_count_ = front_count;
+
+		ComputeCrowdingDistances(count, workspace);
+	}
+
+	//! Every (front, objective) pair is a task: its members are sorted by the objective, the boundary members
+	//! get infinity and the others the normalized gap between their neighbours. The parts are summed
+	//! objective by objective, so the distance doesn't depend on the thread count.
+	void ComputeCrowdingDistances(const size_t count, Workspace& workspace) const
+	{
+		const auto& sorter = workspace.sorter_;
+		const auto* members = sorter.Members().data();
+		const size_t front_count = workspace.ranked_front_count_;
+		const size_t ranked_count = sorter.FrontBegin(front_count);
+
+		workspace.objective_orders_.resize(objective_count_ * ranked_count);
+		workspace.distance_parts_.resize(objective_count_ * count);
+
+		const Objectives* objectives = workspace.objectives_.data();
+		ParallelFor(front_count * objective_count_, 1,
+				[&](const size_t begin, const size_t end)
+				{
+					for (size_t task = begin; task < end; ++task)
+					{
+						const size_t front = task / objective_count_;
+						const size_t objective = task % objective_count_;
+						const size_t front_begin = sorter.FrontBegin(front);
+						const size_t front_end = sorter.FrontBegin(front + 1);
+
+						uint32_t* order = workspace.objective_orders_.data() + objective * ranked_count;
+						double* parts = workspace.distance_parts_.data() + objective * count;
+						std::copy(members + front_begin, members + front_end, order + front_begin);
+						// Members come in lexicographic order, already sorted by the first objective
+						if (objective != 0)
+						{
+							std::sort(order + front_begin, order + front_end,
+									[objectives, objective](const uint32_t left, const uint32_t right)
+									{
+										return objectives[left][objective] < objectives[right][objective]
+												|| (objectives[left][objective] == objectives[right][objective] && left < right);
+									});
+						}
+						AddCrowdingParts(objectives, objective, order + front_begin, order + front_end, parts);
+					}
+				});
+
+		auto& distances = workspace.crowding_distances_;
+		ParallelFor(ranked_count, chunk_size_,
+				[&](const size_t begin, const size_t end)
+				{
+					for (size_t position = begin; position < end; ++position)
+					{
+						const uint32_t index = members[position];
+						double distance = 0.0;
+						for (size_t objective = 0; objective < objective_count_; ++objective)
+						{
+							distance += workspace.distance_parts_[objective * count + index];
+						}
+						distances[index] = distance;
+					}
+				});
+	}
+
+	//! An objective with the same value for the whole front adds nothing.
+	static void AddCrowdingParts(
+			const Objectives* objectives,
+			const size_t objective,
+			const uint32_t* begin,
+			const uint32_t* end,
+			double* parts)
+	{
+		const size_t size = end - begin;
+		const double low = objectives[begin[0]][objective];
+		const double high = objectives[begin[size - 1]][objective];
+		if (size <= 2 || !(high > low))
+		{
+			const double part = size <= 2 ? std::numeric_limits<double>::infinity() : 0.0;
+			for (const uint32_t* member = begin; member != end; ++member)
+			{
+				parts[*member] = part;
+			}
+			return;
+		}
+
+		parts[begin[0]] = std::numeric_limits<double>::infinity();
+		parts[begin[size - 1]] = std::numeric_limits<double>::infinity();
+		const double scale = 1.0 / (high - low);
+		for (size_t position = 1; position + 1 < size; ++position)
+		{
+			parts[begin[position]] = (objectives[begin[position + 1]][objective]
+					- objectives[begin[position - 1]][objective]) * scale;
+		}
+	}
+
+	//! Whole fronts while they fit, then the most isolated members of the next one.
+	void SelectSurvivors(const size_t population_size, Workspace& workspace) const
+	{
+		const auto& sorter = workspace.sorter_;
+		const auto& members = sorter.Members();
+		const size_t last_front = workspace.ranked_front_count_ - 1;
+		const size_t last_begin = sorter.FrontBegin(last_front);
+
+		auto& survivors = workspace.survivors_;
+		survivors.assign(members.begin(), members.begin() + sorter.FrontBegin(last_front + 1));
+		if (survivors.size() > population_size)
+		{
+			const auto& distances = workspace.crowding_distances_;
+			std::nth_element(survivors.begin() + last_begin,
+					survivors.begin() + population_size - 1,
+					survivors.end(),
+					[&distances](const uint32_t left, const uint32_t right)
+					{
+						return distances[left] > distances[right] || (distances[left] == distances[right] && left < right);
+					});
+			survivors.resize(population_size);
+		}
+	}
+
+	//! Ranks of the survivors among parents and children are their ranks among the survivors:
+	//! the dropped individuals are in the last kept front or after it, so they don't dominate any survivor.
+	void GatherSurvivors(Workspace& workspace) const
+	{
+		const auto& ranks = workspace.sorter_.Ranks();
+		const auto& survivors = workspace.survivors_;
+		ParallelFor(survivors.size(), chunk_size_,
+				[&](const size_t begin, const size_t end)
+				{
+					for (size_t position = begin; position < end; ++position)
+					{
+						const uint32_t index = survivors[position];
+						workspace.next_population_[position] = workspace.population_[index];
+						workspace.next_objectives_[position] = workspace.objectives_[index];
+						workspace.next_ranks_[position] = ranks[index];
+						workspace.next_crowding_distances_[position] = workspace.crowding_distances_[index];
+					}
+				});
+
+		std::swap(workspace.population_, workspace.next_population_);
+		std::swap(workspace.objectives_, workspace.next_objectives_);
+		std::swap(workspace.ranks_, workspace.next_ranks_);
+		std::swap(workspace.crowding_distances_, workspace.next_crowding_distances_);
+	}
+
+	template <typename ChunkFunction>
+	void ParallelFor(const size_t count, const size_t chunk_size, ChunkFunction&& function) const
+	{
+		if (thread_pool_)
+		{
+			thread_pool_->ParallelFor(count, chunk_size, function);
+			return;
+		}
+
+		for (size_t begin = 0; begin < count; begin += chunk_size)
+		{
+			function(begin, std::min(begin + chunk_size, count));
+		}
+	}
+
+	std::shared_ptr<Strategy> strategy_;
+	ThreadPoolPtr thread_pool_;
+
+	constexpr static size_t chunk_size_ = 1024;
+	constexpr static size_t objective_count_ = std::tuple_size_v<Objectives>;
+};
+
+template <typename Genotype, size_t ObjectiveCount>
+using MultiObjectiveGeneticAlgorithmPtr =
+		std::shared_ptr<MultiObjectiveGeneticAlgorithm<IMultiObjectiveStrategy<Genotype, ObjectiveCount>>>;
+
+} // GeneticAlgorithm
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <tuple>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! First is no worse than second in every objective and better in at least one, all objectives are minimized.
+template <typename Objectives>
+bool IsDominating(const Objectives& first, const Objectives& second)
+{
+	bool is_better = false;
+	for (size_t objective = 0; objective < first.size(); ++objective)
+	{
+		if (second[objective] < first[objective])
+		{
+			return false;
+		}
+		is_better = is_better || first[objective] < second[objective];
+	}
+	return is_better;
+}
+
+//! Splits objective vectors into non-dominated fronts, front 0 is the Pareto front.
+//! The vectors are sorted lexicographically first, then a vector can only be dominated by the ones before it,
+//! and its front is found by a binary search over the fronts built so far (Zhang et al., "An Efficient Approach
+//! to Non-dominated Sorting for Evolutionary Multiobjective Optimization").
+//! With two objectives the last member of a front decides for the whole front, so sorting is O(N log N);
+//! with more objectives the members of a front are checked, O(M N log N) at best and O(M N^2) at worst.
+//! Buffers are kept between calls.
+template <typename Objectives>
+class NonDominatedSorter
+{
+public:
+
+	void Sort(const Objectives* objectives, const size_t count)
+	{
+		order_.resize(count);
+		std::iota(order_.begin(), order_.end(), uint32_t{0});
+		std::sort(order_.begin(), order_.end(),
+				[objectives](const uint32_t left, const uint32_t right)
+				{
+					return objectives[left] < objectives[right] || (objectives[left] == objectives[right] && left < right);
+				});
+
+		ranks_.resize(count);
+		if constexpr (std::tuple_size_v<Objectives> == 2)
+		{
+			SortTwoObjectives(objectives);
+		}
+		else
+		{
+			SortObjectives(objectives);
+		}
+		GroupFronts();
+	}
+
+	//! Front of every vector.
+	const std::vector<uint32_t>& Ranks() const
+	{
+		return ranks_;
+	}
+
+	size_t FrontCount() const
+	{
+		return front_begins_.size() - 1;
+	}
+
+	//! Members of front are Members()[FrontBegin(front), FrontBegin(front + 1)), in lexicographic order.
+	size_t FrontBegin(const size_t front) const
+	{
+		return front_begins_[front];
+	}
+
+	const std::vector<uint32_t>& Members() const
+	{
+		return members_;
+	}
+
+private:
+
+	void SortTwoObjectives(const Objectives* objectives)
+	{
+		// The last member of a front has the largest first and the smallest second objective of the front,
+		// it dominates a later vector whenever any member does
+		front_count_ = 0;
+		for (const uint32_t index : order_)
+		{
+			size_t low = 0;
+			size_t high = front_count_;
+			while (low < high)
+			{
+				const size_t middle = (low + high) / 2;
+				if (IsDominating(objectives[fronts_[middle].back()], objectives[index]))
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+
+			AddToFront(low, index);
+		}
+	}
+
+	void SortObjectives(const Objectives* objectives)
+	{
+		front_count_ = 0;
+		for (const uint32_t index : order_)
+		{
+			size_t low = 0;
+			size_t high = front_count_;
+			while (low < high)
+			{
+				const size_t middle = (low + high) / 2;
+				if (IsFrontDominating(objectives, fronts_[middle], objectives[index]))
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+
+			AddToFront(low, index);
+		}
+	}
+
+	//! The latest members are checked first, they are the closest in the lexicographic order.
+	static bool IsFrontDominating(const Objectives* objectives, const std::vector<uint32_t>& front, const Objectives& point)
+	{
+		for (auto member = front.rbegin(); member != front.rend(); ++member)
+		{
+			if (IsDominating(objectives[*member], point))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void AddToFront(const size_t front, const uint32_t index)
+	{
+		if (front == front_count_)
+		{
+			if (front_count_ == fronts_.size())
+			{
+				fronts_.emplace_back();
+			}
+			fronts_[front_count_++].clear();
+		}
+		fronts_[front].push_back(index);
+		ranks_[index] = static_cast<uint32_t>(front);
+	}
+
+	void GroupFronts()
+	{
+		front_begins_.assign(front_count_ + 1, 0);
+		for (size_t front = 0; front < front_count_; ++front)
+		{
+			front_begins_[front + 1] = front_begins_[front] + fronts_[front].size();
+		}
+
+		members_.resize(order_.size());
+		for (size_t front = 0; front < front_count_; ++front)
+		{
+			std::copy(fronts_[front].begin(), fronts_[front].end(), members_.begin() + front_begins_[front]);
+		}
+	}
+
+	std::vector<uint32_t> order_;
+	std::vector<uint32_t> ranks_;
+	//! Only the first front_count_ fronts belong to the current call, the others keep their memory.
+	std::vector<std::vector<uint32_t>> fronts_;
+	size_t front_count_ = 0;
+	std::vector<size_t> front_begins_;
+	std::vector<uint32_t> members_;
+};
+
+} // GeneticAlgorithm
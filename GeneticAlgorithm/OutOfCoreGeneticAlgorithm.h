@@ -0,0 +1,374 @@
+#pragma once
+
+#include <chrono>
+#include <limits>
+
+#include "stable.h"
+#include "IGeneticAlgorithmStrategy.h"
+#include "MappedPopulation.h"
+#include "PopulationStatistics.h"
+#include "Random.h"
+#include "State.h"
+#include "ThreadPool.h"
+
+namespace GA
+{
+
+template <typename Genotype, typename Value>
+struct OutOfCoreResult
+{
+	//! The last generation, it stays in the population file.
+	MappedPopulationPtr<Genotype, Value> population_;
+	PopulationStatistics<Value> statistics_;
+	size_t iteration_count_ = 0;
+	uint64_t seed_ = 0;
+	std::optional<long> times_ = std::nullopt;
+};
+
+//! Generational engine for a population in a MappedPopulation, which may be larger than memory.
+//! The population is cut into blocks of block_size individuals; every thread takes every ThreadCount-th block
+//! in order, so each pass reads and writes the file sequentially and only the blocks in work are resident.
+//! A generation makes two passes. The crossingover pass replaces the individuals of a block that scored worse
+//! than the best (1 - crossingover_part) of the block by children of two survivors: one of the block
+//! and one of its partner block, which moves by one block every generation, so genotypes spread
+//! through the whole population without a global sort or random access to the file.
+//! The mutation pass mutates mutation_part of a block in place, scores the changed individuals
+//! and finds the survivor threshold of the block for the next generation while its scores are in cache.
+//! Every block and child has its own random stream, so a seed gives one result for any thread count.
+template <typename Strategy>
+class OutOfCoreGeneticAlgorithm
+{
+public:
+
+	using StrategyType = Strategy;
+	using Genotype = typename Strategy::GenotypeType;
+	using ScoreValue = typename Strategy::ValueType;
+
+	OutOfCoreGeneticAlgorithm(
+			const std::shared_ptr<Strategy>& strategy,
+			const size_t thread_count = 1,
+			const size_t block_size = 1 << 20)
+			: strategy_(strategy)
+			, block_size_(block_size)
+	{
+		if (!strategy)
+		{
+			throw std::runtime_error("Empty strategy");
+		}
+		if (thread_count == 0)
+		{
+			throw std::runtime_error("Thread count must be positive");
+		}
+		if (block_size == 0 || block_size > std::numeric_limits<uint32_t>::max())
+		{
+			throw std::runtime_error("Block size must be positive and fit in 32 bits");
+		}
+		if (thread_count > 1)
+		{
+			thread_pool_ = std::make_shared<ThreadPool>(thread_count);
+		}
+	}
+
+	size_t ThreadCount() const
+	{
+		return thread_pool_ ? thread_pool_->ThreadCount() : 1;
+	}
+
+	//! Runs limit generations over population, there is no convergence check:
+	//! the strategy checks convergence on a population in memory.
+	template <bool IsMeasuringTime = false>
+	OutOfCoreResult<Genotype, ScoreValue> Calculation(
+			const MappedPopulationPtr<Genotype, ScoreValue>& population,
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit = 1000,
+			const uint64_t seed = std::random_device{}()) const
+	{
+		if (!population)
+		{
+			throw std::runtime_error("Empty population");
+		}
+		if (mutation_part < 0.0 || mutation_part > 1.0 || crossingover_part < 0.0 || crossingover_part >= 1.0)
+		{
+			throw std::runtime_error("Mutation part must be in [0, 1] and crossingover part in [0, 1)");
+		}
+
+		std::chrono::steady_clock::time_point start_time;
+		if constexpr (IsMeasuringTime)
+		{
+			start_time = std::chrono::steady_clock::now();
+		}
+
+		const RandomStreams streams(seed);
+		Workspace workspace;
+		workspace.block_count_ = (population->Size() + block_size_ - 1) / block_size_;
+		workspace.lanes_.resize(std::min(ThreadCount(), workspace.block_count_));
+		workspace.thresholds_.resize(workspace.block_count_);
+		workspace.statistics_accumulator_.Reset(workspace.block_count_);
+
+		ForEachBlock(*population, workspace,
+				[&](Lane& lane, const size_t block, const size_t begin, const size_t end)
+				{
+					RandomGenerator generator = streams.Stream(RandomStreamPurpose::StartPopulation, 0, block);
+					strategy_->CreateStartGenotypes(generator, population->Genotypes() + begin, end - begin);
+					strategy_->FitnessFunctionBatch(
+							population->Genotypes() + begin, end - begin, population->Scores() + begin);
+					FinishBlock(*population, crossingover_part, block, begin, end, lane, workspace);
+				});
+
+		size_t iteration_count = 0;
+		for (; iteration_count < limit; ++iteration_count)
+		{
+			ApplyCrossingover(*population, iteration_count, streams, workspace);
+			ApplyMutation(*population, mutation_part, crossingover_part, iteration_count, streams, workspace);
+			strategy_->EndGeneration();
+		}
+
+		OutOfCoreResult<Genotype, ScoreValue> result;
+		result.population_ = population;
+		result.statistics_ = workspace.statistics_accumulator_.Combine();
+		result.iteration_count_ = iteration_count;
+		result.seed_ = seed;
+
+		if constexpr (IsMeasuringTime)
+		{
+			result.times_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_time).count();
+		}
+		return result;
+	}
+
+private:
+
+	//! Buffers of one thread, they hold a block at most.
+	struct Lane
+	{
+		std::vector<ScoreValue> scores_;
+		std::vector<uint8_t> is_mutated_;
+		std::vector<size_t> changed_;
+		Population<Genotype> changed_genotypes_;
+		std::vector<ScoreValue> changed_scores_;
+	};
+
+	struct Workspace
+	{
+		size_t block_count_ = 0;
+		std::vector<Lane> lanes_;
+		//! Individuals of a block with a score above its threshold are replaced in the next crossingover pass.
+		std::vector<ScoreValue> thresholds_;
+		PopulationStatisticsAccumulator<ScoreValue> statistics_accumulator_;
+	};
+
+	//! Reads the survivors of the block and of its partner, writes only the replaced individuals of the block,
+	//! which are never parents, so blocks don't wait for each other.
+	void ApplyCrossingover(
+			const MappedPopulation<Genotype, ScoreValue>& population,
+			const size_t iteration_count,
+			const RandomStreams& streams,
+			Workspace& workspace) const
+	{
+		const size_t block_count = workspace.block_count_;
+		ForEachBlock(population, workspace,
+				[&](Lane& /*lane*/, const size_t block, const size_t begin, const size_t end)
+				{
+					const size_t partner = block_count == 1
+							? block : (block + 1 + iteration_count % (block_count - 1)) % block_count;
+					const auto [partner_begin, partner_end] = BlockRange(population, partner);
+					population.Prefetch(partner_begin, partner_end);
+
+					Genotype* genotypes = population.Genotypes();
+					const ScoreValue* scores = population.Scores();
+					const ScoreValue threshold = workspace.thresholds_[block];
+					for (size_t index = begin; index < end; ++index)
+					{
+						if (!(scores[index] > threshold))
+						{
+							continue;
+						}
+
+						RandomGenerator generator = streams.Stream(
+								RandomStreamPurpose::Crossingover, iteration_count, index);
+						const size_t first = PickSurvivor(population, workspace, block, generator);
+						const size_t second = PickSurvivor(population, workspace, partner, generator);
+						strategy_->CrossingoverInto(
+								genotypes[first], scores[first],
+								genotypes[second], scores[second],
+								genotypes[index],
+								generator);
+					}
+				});
+	}
+
+	//! The replaced individuals still have the scores of their predecessors here, above the threshold.
+	void ApplyMutation(
+			const MappedPopulation<Genotype, ScoreValue>& population,
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t iteration_count,
+			const RandomStreams& streams,
+			Workspace& workspace) const
+	{
+		ForEachBlock(population, workspace,
+				[&](Lane& lane, const size_t block, const size_t begin, const size_t end)
+				{
+					const size_t size = end - begin;
+					lane.is_mutated_.assign(size, 0);
+					RandomGenerator sampling_generator = streams.Stream(
+							RandomStreamPurpose::Sampling, iteration_count, block);
+					const size_t mutation_count = static_cast<size_t>(mutation_part * static_cast<double>(size));
+					for (size_t sample = 0; sample < mutation_count; ++sample)
+					{
+						lane.is_mutated_[UniformIndex(sampling_generator, static_cast<uint32_t>(size))] = 1;
+					}
+
+					Genotype* genotypes = population.Genotypes();
+					ScoreValue* scores = population.Scores();
+					for (size_t offset = 0; offset < size; ++offset)
+					{
+						if (lane.is_mutated_[offset])
+						{
+							RandomGenerator generator = streams.Stream(
+									RandomStreamPurpose::Mutation, iteration_count, begin + offset);
+							strategy_->MutationInPlace(genotypes[begin + offset], iteration_count, generator);
+						}
+					}
+
+					if (strategy_->IsIncrementalFitness())
+					{
+						ScoreChanged(population, workspace.thresholds_[block], begin, end, lane);
+					}
+					else
+					{
+						strategy_->FitnessFunctionBatch(genotypes + begin, size, scores + begin);
+					}
+					FinishBlock(population, crossingover_part, block, begin, end, lane, workspace);
+				});
+	}
+
+	//! Gathers the mutated and replaced individuals, scores them in one batch and scatters the scores back.
+	void ScoreChanged(
+			const MappedPopulation<Genotype, ScoreValue>& population,
+			const ScoreValue threshold,
+			const size_t begin,
+			const size_t end,
+			Lane& lane) const
+	{
+		Genotype* genotypes = population.Genotypes();
+		ScoreValue* scores = population.Scores();
+
+		lane.changed_.clear();
+		for (size_t index = begin; index < end; ++index)
+		{
+			if (lane.is_mutated_[index - begin] || scores[index] > threshold)
+			{
+				lane.changed_.push_back(index);
+			}
+		}
+
+		lane.changed_genotypes_.resize(lane.changed_.size());
+		lane.changed_scores_.resize(lane.changed_.size());
+		for (size_t position = 0; position < lane.changed_.size(); ++position)
+		{
+			lane.changed_genotypes_[position] = genotypes[lane.changed_[position]];
+		}
+		strategy_->FitnessFunctionBatch(
+				lane.changed_genotypes_.data(), lane.changed_genotypes_.size(), lane.changed_scores_.data());
+		for (size_t position = 0; position < lane.changed_.size(); ++position)
+		{
+			scores[lane.changed_[position]] = lane.changed_scores_[position];
+		}
+	}
+
+	//! Collects the statistics of a scored block and its threshold: the score of its survivor_count-th best individual.
+	//! Ties with the threshold survive, so a block with equal scores keeps more survivors.
+	void FinishBlock(
+			const MappedPopulation<Genotype, ScoreValue>& population,
+			const double crossingover_part,
+			const size_t block,
+			const size_t begin,
+			const size_t end,
+			Lane& lane,
+			Workspace& workspace) const
+	{
+		const ScoreValue* scores = population.Scores();
+		workspace.statistics_accumulator_.AddChunk(block, scores, begin, end);
+
+		const size_t size = end - begin;
+		const size_t replaced_count = static_cast<size_t>(crossingover_part * static_cast<double>(size));
+		const size_t survivor_count = std::max<size_t>(size - replaced_count, 1);
+		lane.scores_.assign(scores + begin, scores + end);
+		std::nth_element(lane.scores_.begin(), lane.scores_.begin() + (survivor_count - 1), lane.scores_.end());
+		workspace.thresholds_[block] = lane.scores_[survivor_count - 1];
+
+		population.Release(begin, end);
+	}
+
+	//! Uniform survivor of block by rejection, at least one in (1 - crossingover_part) individuals is a survivor.
+	size_t PickSurvivor(
+			const MappedPopulation<Genotype, ScoreValue>& population,
+			const Workspace& workspace,
+			const size_t block,
+			RandomGenerator& generator) const
+	{
+		const auto [begin, end] = BlockRange(population, block);
+		const ScoreValue* scores = population.Scores();
+		const ScoreValue threshold = workspace.thresholds_[block];
+		for (;;)
+		{
+			const size_t index = begin + UniformIndex(generator, static_cast<uint32_t>(end - begin));
+			if (!(scores[index] > threshold))
+			{
+				return index;
+			}
+		}
+	}
+
+	std::pair<size_t, size_t> BlockRange(const MappedPopulation<Genotype, ScoreValue>& population, const size_t block) const
+	{
+		const size_t begin = block * block_size_;
+		return {begin, std::min(begin + block_size_, population.Size())};
+	}
+
+	//! Lane l takes blocks l, l + lane count, ... in order and prefetches the next one before it works on a block.
+	template <typename BlockFunction>
+	void ForEachBlock(
+			const MappedPopulation<Genotype, ScoreValue>& population,
+			Workspace& workspace,
+			BlockFunction&& function) const
+	{
+		const size_t lane_count = workspace.lanes_.size();
+		const auto run_lanes = [&](const size_t lane_begin, const size_t lane_end)
+		{
+			for (size_t lane = lane_begin; lane < lane_end; ++lane)
+			{
+				for (size_t block = lane; block < workspace.block_count_; block += lane_count)
+				{
+					if (block + lane_count < workspace.block_count_)
+					{
+						const auto [next_begin, next_end] = BlockRange(population, block + lane_count);
+						population.Prefetch(next_begin, next_end);
+					}
+					const auto [begin, end] = BlockRange(population, block);
+					function(workspace.lanes_[lane], block, begin, end);
+				}
+			}
+		};
+
+		if (thread_pool_)
+		{
+			thread_pool_->ParallelFor(lane_count, 1, run_lanes);
+			return;
+		}
+		run_lanes(0, lane_count);
+	}
+
+	std::shared_ptr<Strategy> strategy_;
+	size_t block_size_;
+	ThreadPoolPtr thread_pool_;
+};
+
+template <typename Genotype, typename Value>
+using OutOfCoreGeneticAlgorithmPtr =
+		std::shared_ptr<OutOfCoreGeneticAlgorithm<IGeneticAlgorithmStrategy<Genotype, Value>>>;
+
+} // GeneticAlgorithm
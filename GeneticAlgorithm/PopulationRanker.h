@@ -0,0 +1,65 @@
+#pragma once
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Splits a population by selection key into the replaced part (highest keys) and the survived part.
+//! Equal keys are ordered by index, so the split is the same as in a stable descending sort,
+//! but only nth_element is used and the index buffer is reused between generations.
+class PopulationRanker
+{
+	using Index = size_t;
+	using Indexes = std::vector<Index>;
+
+public:
+
+	//! Ranks so that the split_position highest keys come first and the key at split_position follows them.
+	//! The replaced part is [0, split_position], the survived part is [split_position, size),
+	//! the individual at split_position belongs to both parts.
+	template <typename Key>
+	void Rank(const std::vector<Key>& keys, const size_t split_position)
+	{
+		assert(split_position < keys.size());
+
+		order_.resize(keys.size());
+		std::iota(order_.begin(), order_.end(), Index{0});
+
+		std::nth_element(order_.begin(), order_.begin() + split_position, order_.end(),
+				[&keys](const Index left, const Index right)
+				{
+					return keys[left] > keys[right] || (!(keys[right] > keys[left]) && left < right);
+				});
+
+		split_position_ = split_position;
+	}
+
+	size_t ReplacedCount() const
+	{
+		return split_position_ + 1;
+	}
+
+	Index Replaced(const size_t position) const
+	{
+		assert(position < ReplacedCount());
+		return order_[position];
+	}
+
+	size_t SurvivedCount() const
+	{
+		return order_.size() - split_position_;
+	}
+
+	Index Survived(const size_t position) const
+	{
+		assert(position < SurvivedCount());
+		return order_[split_position_ + position];
+	}
+
+private:
+	Indexes order_;
+	size_t split_position_ = 0;
+};
+
+} // GeneticAlgorithm
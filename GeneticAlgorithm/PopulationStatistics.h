@@ -0,0 +1,243 @@
+#pragma once
+
+#include "stable.h"
+
+#if defined(__SSE2__)
+#define GA_POPULATION_STATISTICS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace GA
+{
+
+//! Score statistics of one generation, the lowest score is the best one.
+//! A NaN score is never the best or the worst one unless all scores are NaN, it makes the mean and variance NaN.
+template <typename Value>
+struct PopulationStatistics
+{
+	size_t count_ = 0;
+	double mean_ = 0.0;
+	double variance_ = 0.0;
+	Value min_{};
+	Value max_{};
+	size_t best_index_ = 0;
+	size_t worst_index_ = 0;
+};
+
+//! Collects statistics chunk by chunk, right after a chunk is scored and while its scores are in cache.
+//! Chunks may be added from different threads, they are combined in chunk order,
+//! so the result depends only on the chunk size and not on the thread count.
+template <typename Value>
+class PopulationStatisticsAccumulator
+{
+	struct Partial
+	{
+		size_t count_ = 0;
+		double sum_ = 0.0;
+		double squared_deviation_ = 0.0;
+		Value min_{};
+		Value max_{};
+		size_t min_index_ = 0;
+		size_t max_index_ = 0;
+	};
+
+public:
+
+	void Reset(const size_t chunk_count)
+	{
+		partials_.assign(chunk_count, Partial{});
+	}
+
+	//! scores[begin, end) is the chunk number chunk.
+	void AddChunk(const size_t chunk, const Value* scores, const size_t begin, const size_t end)
+	{
+		assert(chunk < partials_.size() && begin < end);
+		Partial& partial = partials_[chunk];
+		partial.count_ = end - begin;
+
+		const Value* chunk_scores = scores + begin;
+		ReduceChunk(chunk_scores, partial);
+
+		partial.min_index_ = begin + FirstIndexOf(chunk_scores, partial.count_, partial.min_);
+		partial.max_index_ = begin + FirstIndexOf(chunk_scores, partial.count_, partial.max_);
+	}
+
+	//! Chunks are merged with the pairwise formula of Chan, Golub and LeVeque.
+	PopulationStatistics<Value> Combine() const
+	{
+		PopulationStatistics<Value> statistics;
+
+		double sum = 0.0;
+		double squared_deviation = 0.0;
+		for (const Partial& partial : partials_)
+		{
+			if (partial.count_ == 0)
+			{
+				continue;
+			}
+
+			if (statistics.count_ == 0)
+			{
+				statistics.min_ = partial.min_;
+				statistics.max_ = partial.max_;
+				statistics.best_index_ = partial.min_index_;
+				statistics.worst_index_ = partial.max_index_;
+			}
+			else
+			{
+				const double count = static_cast<double>(statistics.count_);
+				const double partial_count = static_cast<double>(partial.count_);
+				const double delta = partial.sum_ / partial_count - sum / count;
+				squared_deviation += delta * delta * count * partial_count / (count + partial_count);
+
+				if (partial.min_ < statistics.min_ || (IsNan(statistics.min_) && !IsNan(partial.min_)))
+				{
+					statistics.min_ = partial.min_;
+					statistics.best_index_ = partial.min_index_;
+				}
+				if (statistics.max_ < partial.max_ || (IsNan(statistics.max_) && !IsNan(partial.max_)))
+				{
+					statistics.max_ = partial.max_;
+					statistics.worst_index_ = partial.max_index_;
+				}
+			}
+
+			sum += partial.sum_;
+			squared_deviation += partial.squared_deviation_;
+			statistics.count_ += partial.count_;
+		}
+
+		if (statistics.count_ != 0)
+		{
+			statistics.mean_ = sum / static_cast<double>(statistics.count_);
+			statistics.variance_ = squared_deviation / static_cast<double>(statistics.count_);
+		}
+		return statistics;
+	}
+
+private:
+
+	//! One pass over the chunk in lane_count_ independent lanes, so the loop has no serial dependency.
+	//! Deviations are taken from the first score of the chunk that isn't NaN, which keeps the squared deviation
+	//! accurate when the scores are close to each other. The SSE2 form keeps the same lanes and gives the same bits.
+	//! Minimums and maximums start from that score and both forms keep the old value when they compare with NaN,
+	//! so they are NaN only when the whole chunk is.
+	static void ReduceChunk(const Value* scores, Partial& partial)
+	{
+		const size_t count = partial.count_;
+		const size_t lane_end = count / lane_count_ * lane_count_;
+		size_t first = 0;
+		while (first + 1 < count && IsNan(scores[first]))
+		{
+			++first;
+		}
+		const Value start = scores[first];
+		const double shift = static_cast<double>(start);
+
+		double sums[lane_count_] = {};
+		double squares[lane_count_] = {};
+		Value mins[lane_count_];
+		Value maxs[lane_count_];
+		std::fill(mins, mins + lane_count_, start);
+		std::fill(maxs, maxs + lane_count_, start);
+
+		size_t index = 0;
+#ifdef GA_POPULATION_STATISTICS_SSE2
+		if constexpr (std::is_same_v<Value, double>)
+		{
+			const __m128d shifts = _mm_set1_pd(shift);
+			__m128d low_sum = _mm_setzero_pd();
+			__m128d high_sum = _mm_setzero_pd();
+			__m128d low_square = _mm_setzero_pd();
+			__m128d high_square = _mm_setzero_pd();
+			__m128d low_min = shifts;
+			__m128d high_min = shifts;
+			__m128d low_max = shifts;
+			__m128d high_max = shifts;
+			for (; index < lane_end; index += lane_count_)
+			{
+				const __m128d low = _mm_loadu_pd(scores + index);
+				const __m128d high = _mm_loadu_pd(scores + index + 2);
+				const __m128d low_deviation = _mm_sub_pd(low, shifts);
+				const __m128d high_deviation = _mm_sub_pd(high, shifts);
+				low_sum = _mm_add_pd(low_sum, low_deviation);
+				high_sum = _mm_add_pd(high_sum, high_deviation);
+				low_square = _mm_add_pd(low_square, _mm_mul_pd(low_deviation, low_deviation));
+				high_square = _mm_add_pd(high_square, _mm_mul_pd(high_deviation, high_deviation));
+				low_min = _mm_min_pd(low, low_min);
+				high_min = _mm_min_pd(high, high_min);
+				low_max = _mm_max_pd(low, low_max);
+				high_max = _mm_max_pd(high, high_max);
+			}
+			_mm_storeu_pd(sums, low_sum);
+			_mm_storeu_pd(sums + 2, high_sum);
+			_mm_storeu_pd(squares, low_square);
+			_mm_storeu_pd(squares + 2, high_square);
+			_mm_storeu_pd(mins, low_min);
+			_mm_storeu_pd(mins + 2, high_min);
+			_mm_storeu_pd(maxs, low_max);
+			_mm_storeu_pd(maxs + 2, high_max);
+		}
+#endif
+		for (; index < lane_end; index += lane_count_)
+		{
+			for (size_t lane = 0; lane < lane_count_; ++lane)
+			{
+				const Value score = scores[index + lane];
+				const double deviation = static_cast<double>(score) - shift;
+				sums[lane] += deviation;
+				squares[lane] += deviation * deviation;
+				mins[lane] = score < mins[lane] ? score : mins[lane];
+				maxs[lane] = maxs[lane] < score ? score : maxs[lane];
+			}
+		}
+		for (; index < count; ++index)
+		{
+			const Value score = scores[index];
+			const double deviation = static_cast<double>(score) - shift;
+			sums[0] += deviation;
+			squares[0] += deviation * deviation;
+			mins[0] = score < mins[0] ? score : mins[0];
+			maxs[0] = maxs[0] < score ? score : maxs[0];
+		}
+
+		const double deviation_sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		const double square_sum = (squares[0] + squares[1]) + (squares[2] + squares[3]);
+		partial.sum_ = shift * static_cast<double>(count) + deviation_sum;
+		partial.squared_deviation_ = std::max(0.0, square_sum - deviation_sum * deviation_sum / static_cast<double>(count));
+
+		partial.min_ = mins[0];
+		partial.max_ = maxs[0];
+		for (size_t lane = 1; lane < lane_count_; ++lane)
+		{
+			partial.min_ = mins[lane] < partial.min_ ? mins[lane] : partial.min_;
+			partial.max_ = partial.max_ < maxs[lane] ? maxs[lane] : partial.max_;
+		}
+	}
+
+	//! The first index of the value among count scores, so ties go to the lowest index; a NaN value matches a NaN score.
+	static size_t FirstIndexOf(const Value* scores, const size_t count, const Value& value)
+	{
+		const bool is_nan = IsNan(value);
+		for (size_t index = 0; index < count; ++index)
+		{
+			if (scores[index] == value || (is_nan && IsNan(scores[index])))
+			{
+				return index;
+			}
+		}
+		assert(false);
+		return 0;
+	}
+
+	static bool IsNan(const Value& value)
+	{
+		return !(value == value);
+	}
+
+	constexpr static size_t lane_count_ = 4;
+
+	std::vector<Partial> partials_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <new>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "stable.h"
+#include "IslandGeneticAlgorithm.h"
+#include "MigrationTransport.h"
+#include "SharedMemoryRegion.h"
+
+namespace GA
+{
+
+//! Islands in separate worker processes forked by the coordinator (the calling process).
+//! A worker builds its solver after the fork, so its population is allocated on the memory node it runs on,
+//! and a crashed worker loses only its own island. Migrants go through SharedMemoryMigrationTransport.
+//! Workers publish the result of IsCorrectResult every generation; the coordinator stops all of them
+//! when required_converged_count_ of the running workers have converged at the same time.
+//! The final populations come back to the coordinator through pipes.
+template <typename Strategy, typename Selector>
+class ProcessIslandGeneticAlgorithm
+{
+public:
+
+	using Solver = BasicGeneticAlgorithm<Strategy, Selector>;
+	using SolverPtr = std::shared_ptr<Solver>;
+	using SolverFactory = std::function<SolverPtr(size_t)>;
+	using Genotype = typename Solver::Genotype;
+	using ScoreValue = typename Solver::ScoreValue;
+
+	static_assert(std::is_trivially_copyable_v<Genotype> && std::is_trivially_copyable_v<ScoreValue>,
+			"Worker processes return populations as raw bytes");
+
+	//! solver_factory is called in every worker with the island number.
+	//! required_converged_count equal to 0 means all workers.
+	ProcessIslandGeneticAlgorithm(
+			const SolverFactory& solver_factory,
+			const size_t process_count,
+			const MigrationOptions& options,
+			const size_t required_converged_count = 0)
+			: solver_factory_(solver_factory)
+			, process_count_(process_count)
+			, options_(options)
+			, required_converged_count_(required_converged_count == 0 ? process_count : required_converged_count)
+	{
+		if (!solver_factory_)
+		{
+			throw std::runtime_error("Empty solver factory");
+		}
+		if (process_count_ == 0)
+		{
+			throw std::runtime_error("Process island model needs at least one process");
+		}
+		if (options_.interval_ == 0)
+		{
+			throw std::runtime_error("Migration interval must be positive");
+		}
+	}
+
+	//! Islands of crashed workers are left empty in the result.
+	IslandGeneticAlgorithmResult<Genotype, ScoreValue> Calculation(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit = 1000,
+			const uint64_t seed = std::random_device{}()) const
+	{
+		size_t channel_count;
+		const auto& links = MakeMigrationLinks(process_count_, options_.topology_, channel_count);
+		SharedMemoryMigrationTransport<Genotype, ScoreValue> transport(
+				channel_count, std::max<size_t>(1, channel_capacity_factor_ * options_.migrant_count_));
+
+		SharedMemoryRegion control_region(sizeof(ControlBlock) + process_count_ * sizeof(WorkerStatus));
+		auto* control = new (control_region.Data()) ControlBlock;
+		auto* statuses = reinterpret_cast<WorkerStatus*>(control + 1);
+		for (size_t island = 0; island < process_count_; ++island)
+		{
+			new (statuses + island) WorkerStatus;
+		}
+
+		const RandomStreams streams(seed);
+		std::vector<Worker> workers(process_count_);
+		for (size_t island = 0; island < process_count_; ++island)
+		{
+			int pipe_ends[2];
+			if (::pipe(pipe_ends) != 0)
+			{
+				Abort(control, workers);
+				throw std::runtime_error("Can't create worker pipe");
+			}
+
+			const pid_t pid = ::fork();
+			if (pid < 0)
+			{
+				::close(pipe_ends[0]);
+				::close(pipe_ends[1]);
+				Abort(control, workers);
+				throw std::runtime_error("Can't fork island worker");
+			}
+
+			if (pid == 0)
+			{
+				::close(pipe_ends[0]);
+				for (size_t other = 0; other < island; ++other)
+				{
+					::close(workers[other].output_);
+				}
+				RunWorker(island, mutation_part, crossingover_part, limit, streams.Derive(island),
+						transport, links[island], *control, statuses[island], pipe_ends[1]);
+			}
+
+			::close(pipe_ends[1]);
+			::fcntl(pipe_ends[0], F_SETFL, ::fcntl(pipe_ends[0], F_GETFL) | O_NONBLOCK);
+			workers[island].pid_ = pid;
+			workers[island].output_ = pipe_ends[0];
+		}
+
+		Coordinate(*control, statuses, workers);
+
+		IslandGeneticAlgorithmResult<Genotype, ScoreValue> result;
+		result.islands_.resize(process_count_);
+		for (size_t island = 0; island < process_count_; ++island)
+		{
+			int status = 0;
+			::waitpid(workers[island].pid_, &status, 0);
+			if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+			{
+				ParseResult(workers[island].bytes_, result.islands_[island]);
+			}
+		}
+
+		FindBestIsland(result);
+		return result;
+	}
+
+private:
+
+	struct alignas(64) ControlBlock
+	{
+		std::atomic<uint32_t> stop_{0};
+	};
+
+	struct alignas(64) WorkerStatus
+	{
+		std::atomic<uint64_t> iteration_count_{0};
+		std::atomic<uint32_t> is_correct_result_{0};
+	};
+
+	struct Worker
+	{
+		pid_t pid_ = -1;
+		int output_ = -1;
+		bool is_running_ = true;
+		std::vector<char> bytes_;
+	};
+
+	[[noreturn]] void RunWorker(
+			const size_t island,
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit,
+			const RandomStreams& streams,
+			IMigrationTransport<Genotype, ScoreValue>& transport,
+			const MigrationLinks& links,
+			const ControlBlock& control,
+			WorkerStatus& status,
+			const int output) const
+	{
+		int exit_code = 0;
+		try
+		{
+			const SolverPtr solver = solver_factory_(island);
+			if (!solver)
+			{
+				throw std::runtime_error("Empty island solver");
+			}
+
+			GeneticAlgorithmResult<Genotype, ScoreValue> result;
+			MigratingIsland<Solver> migrating_island(*solver, transport, links, options_);
+			migrating_island.Run(mutation_part, crossingover_part, streams, result,
+					[&control, &status, limit](const size_t iteration_count, const bool is_correct_result)
+					{
+						status.iteration_count_.store(iteration_count, std::memory_order_relaxed);
+						status.is_correct_result_.store(is_correct_result ? 1 : 0, std::memory_order_release);
+						return control.stop_.load(std::memory_order_acquire) == 0 && iteration_count < limit;
+					});
+
+			WriteResult(output, result);
+		}
+		catch (...)
+		{
+			exit_code = 1;
+		}
+
+		::close(output);
+		::_exit(exit_code);
+	}
+
+	void Coordinate(ControlBlock& control, const WorkerStatus* statuses, std::vector<Worker>& workers) const
+	{
+		std::vector<pollfd> descriptors;
+		std::vector<size_t> islands;
+		char buffer[1 << 16];
+
+		while (true)
+		{
+			descriptors.clear();
+			islands.clear();
+			size_t running_count = 0;
+			size_t converged_count = 0;
+			for (size_t island = 0; island < workers.size(); ++island)
+			{
+				if (!workers[island].is_running_)
+				{
+					continue;
+				}
+				++running_count;
+				converged_count += statuses[island].is_correct_result_.load(std::memory_order_acquire);
+				descriptors.push_back(pollfd{workers[island].output_, POLLIN, 0});
+				islands.push_back(island);
+			}
+
+			if (running_count == 0)
+			{
+				return;
+			}
+
+			if (converged_count >= std::min(required_converged_count_, running_count))
+			{
+				control.stop_.store(1, std::memory_order_release);
+			}
+
+			if (::poll(descriptors.data(), descriptors.size(), poll_timeout_milliseconds_) < 0 && errno != EINTR)
+			{
+				Abort(&control, workers);
+				throw std::runtime_error("Can't poll island workers");
+			}
+
+			for (size_t position = 0; position < descriptors.size(); ++position)
+			{
+				if (descriptors[position].revents == 0)
+				{
+					continue;
+				}
+
+				Worker& worker = workers[islands[position]];
+				while (true)
+				{
+					const ssize_t read_size = ::read(worker.output_, buffer, sizeof(buffer));
+					if (read_size > 0)
+					{
+						worker.bytes_.insert(worker.bytes_.end(), buffer, buffer + read_size);
+						continue;
+					}
+					if (read_size < 0 && (errno == EAGAIN || errno == EINTR))
+					{
+						break;
+					}
+
+					::close(worker.output_);
+					worker.is_running_ = false;
+					break;
+				}
+			}
+		}
+	}
+
+	static void Abort(ControlBlock* control, std::vector<Worker>& workers)
+	{
+		control->stop_.store(1, std::memory_order_release);
+		for (auto& worker : workers)
+		{
+			if (worker.pid_ > 0)
+			{
+				if (worker.is_running_)
+				{
+					::close(worker.output_);
+				}
+				::waitpid(worker.pid_, nullptr, 0);
+				worker.pid_ = -1;
+			}
+		}
+	}
+
+	static void WriteAll(const int output, const void* data, size_t size)
+	{
+		const char* bytes = static_cast<const char*>(data);
+		while (size != 0)
+		{
+			const ssize_t written = ::write(output, bytes, size);
+			if (written < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				throw std::runtime_error("Can't write island result");
+			}
+			bytes += written;
+			size -= static_cast<size_t>(written);
+		}
+	}
+
+	//! Layout: iteration count, seed, population size, genotypes, scores.
+	static void WriteResult(const int output, const GeneticAlgorithmResult<Genotype, ScoreValue>& result)
+	{
+		const auto& state = result.final_state_;
+		const uint64_t header[3] = {result.iteration_count_, result.seed_, state.current_population_.size()};
+		WriteAll(output, header, sizeof(header));
+		WriteAll(output, state.current_population_.data(), state.current_population_.size() * sizeof(Genotype));
+		WriteAll(output, state.current_population_score_.data(), state.current_population_score_.size() * sizeof(ScoreValue));
+	}
+
+	static void ParseResult(const std::vector<char>& bytes, GeneticAlgorithmResult<Genotype, ScoreValue>& result)
+	{
+		uint64_t header[3];
+		if (bytes.size() < sizeof(header))
+		{
+			return;
+		}
+		std::memcpy(header, bytes.data(), sizeof(header));
+
+		const uint64_t size = header[2];
+		if (bytes.size() != sizeof(header) + size * (sizeof(Genotype) + sizeof(ScoreValue)))
+		{
+			return;
+		}
+
+		result.iteration_count_ = header[0];
+		result.seed_ = header[1];
+		result.final_state_.current_population_.resize(size);
+		result.final_state_.current_population_score_.resize(size);
+
+		const char* genotypes = bytes.data() + sizeof(header);
+		std::memcpy(static_cast<void*>(result.final_state_.current_population_.data()), genotypes, size * sizeof(Genotype));
+		std::memcpy(static_cast<void*>(result.final_state_.current_population_score_.data()),
+				genotypes + size * sizeof(Genotype), size * sizeof(ScoreValue));
+	}
+
+	constexpr static size_t channel_capacity_factor_ = 4;
+	constexpr static int poll_timeout_milliseconds_ = 10;
+
+	SolverFactory solver_factory_;
+	size_t process_count_;
+	MigrationOptions options_;
+	size_t required_converged_count_;
+};
+
+template <typename Strategy, typename Selector>
+using ProcessIslandGeneticAlgorithmPtr = std::shared_ptr<ProcessIslandGeneticAlgorithm<Strategy, Selector>>;
+
+} // GeneticAlgorithm
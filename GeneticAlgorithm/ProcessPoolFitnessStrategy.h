@@ -0,0 +1,126 @@
+#pragma once
+
+#include "stable.h"
+#include "EvaluatorProcessPool.h"
+#include "IGeneticAlgorithmStrategy.h"
+
+namespace GA
+{
+
+//! Scores genotypes in the worker processes of an EvaluatorProcessPool, for fitness functions that live
+//! in other binaries; the wrapped strategy provides the other operators. Genotypes and scores cross
+//! the process boundary as raw bytes, a batch of the engine goes out as a few large requests.
+template <typename Genotype, typename Value>
+class ProcessPoolFitnessStrategy final : public IGeneticAlgorithmStrategy<Genotype, Value>
+{
+	using Population = std::vector<Genotype>;
+	using ScorePopulation = std::vector<Value>;
+
+public:
+
+	static_assert(std::is_trivially_copyable_v<Genotype> && std::is_trivially_copyable_v<Value>,
+			"Evaluator frames hold raw bytes of genotypes and scores");
+
+	ProcessPoolFitnessStrategy(
+			const IGeneticAlgorithmStrategyPtr<Genotype, Value>& strategy,
+			const EvaluatorProcessPoolPtr& pool)
+			: strategy_(strategy)
+			, pool_(pool)
+	{
+		if (!strategy_)
+		{
+			throw std::runtime_error("Empty strategy");
+		}
+		if (!pool_)
+		{
+			throw std::runtime_error("Empty evaluator pool");
+		}
+		if (pool_->ItemSize() != sizeof(Genotype) || pool_->ResultSize() != sizeof(Value))
+		{
+			throw std::runtime_error("Evaluator pool element sizes differ from the genotype and the score");
+		}
+	}
+
+	Population CreateStartPopulation(RandomGenerator& generator) const override
+	{
+		return strategy_->CreateStartPopulation(generator);
+	}
+
+	void CreateStartGenotypes(RandomGenerator& generator, Genotype* genotypes, const size_t count) const override
+	{
+		strategy_->CreateStartGenotypes(generator, genotypes, count);
+	}
+
+	Genotype Mutation(
+			const Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const override
+	{
+		return strategy_->Mutation(genotype, iteration_count, generator);
+	}
+
+	Genotype Crossingover(
+			const Genotype& first_parent, const Value first_score,
+			const Genotype& second_parent, const Value second_score,
+			RandomGenerator& generator) const override
+	{
+		return strategy_->Crossingover(first_parent, first_score, second_parent, second_score, generator);
+	}
+
+	void MutationInPlace(
+			Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const override
+	{
+		strategy_->MutationInPlace(genotype, iteration_count, generator);
+	}
+
+	void CrossingoverInto(
+			const Genotype& first_parent, const Value first_score,
+			const Genotype& second_parent, const Value second_score,
+			Genotype& child,
+			RandomGenerator& generator) const override
+	{
+		strategy_->CrossingoverInto(first_parent, first_score, second_parent, second_score, child, generator);
+	}
+
+	Value FitnessFunction(const Genotype& genotype) const override
+	{
+		Value value;
+		pool_->Evaluate(&genotype, 1, &value);
+		return value;
+	}
+
+	void FitnessFunctionBatch(const Genotype* genotypes, const size_t count, Value* scores) const override
+	{
+		pool_->Evaluate(genotypes, count, scores);
+	}
+
+	//! A round trip to the workers costs more than finding the changed genotypes.
+	bool IsIncrementalFitness() const override
+	{
+		return true;
+	}
+
+	void EndGeneration() const override
+	{
+		strategy_->EndGeneration();
+	}
+
+	bool IsCorrectResult(
+			const Population& population,
+			const ScorePopulation& score_population,
+			const PopulationStatistics<Value>& previous_statistics,
+			const PopulationStatistics<Value>& statistics) const override
+	{
+		return strategy_->IsCorrectResult(population, score_population, previous_statistics, statistics);
+	}
+
+	~ProcessPoolFitnessStrategy() override = default;
+
+private:
+	IGeneticAlgorithmStrategyPtr<Genotype, Value> strategy_;
+	EvaluatorProcessPoolPtr pool_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Counter-based Philox4x32-10 generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+//! The sequence is a pure function of the key and the counter, so any stream can be created
+//! directly without advancing the others.
+class Philox4x32
+{
+	using Block = std::array<uint32_t, 4>;
+
+public:
+
+	using result_type = uint32_t;
+
+	Philox4x32(const uint64_t key, const uint32_t stream_low, const uint32_t stream_middle, const uint32_t stream_high)
+			: key_{static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)}
+			, counter_{0, stream_low, stream_middle, stream_high}
+	{}
+
+	static constexpr result_type min()
+	{
+		return std::numeric_limits<result_type>::min();
+	}
+
+	static constexpr result_type max()
+	{
+		return std::numeric_limits<result_type>::max();
+	}
+
+	result_type operator()()
+	{
+		if (position_ == output_.size())
+		{
+			output_ = Generate(counter_, key_);
+			++counter_[0];
+			position_ = 0;
+		}
+		return output_[position_++];
+	}
+
+	void discard(unsigned long long count)
+	{
+		for (; count != 0; --count)
+		{
+			(*this)();
+		}
+	}
+
+private:
+
+	static void MultiplyHighLow(const uint32_t left, const uint32_t right, uint32_t& high, uint32_t& low)
+	{
+		const uint64_t product = static_cast<uint64_t>(left) * right;
+		high = static_cast<uint32_t>(product >> 32);
+		low = static_cast<uint32_t>(product);
+	}
+
+	static Block Generate(Block counter, std::array<uint32_t, 2> key)
+	{
+		constexpr uint32_t multiplier_0 = 0xD2511F53;
+		constexpr uint32_t multiplier_1 = 0xCD9E8D57;
+		constexpr uint32_t weyl_0 = 0x9E3779B9;
+		constexpr uint32_t weyl_1 = 0xBB67AE85;
+
+		for (size_t round = 0; round < 10; ++round)
+		{
+			uint32_t high_0, low_0, high_1, low_1;
+			MultiplyHighLow(multiplier_0, counter[0], high_0, low_0);
+			MultiplyHighLow(multiplier_1, counter[2], high_1, low_1);
+
+			counter = {high_1 ^ counter[1] ^ key[0], low_1, high_0 ^ counter[3] ^ key[1], low_0};
+
+			key[0] += weyl_0;
+			key[1] += weyl_1;
+		}
+		return counter;
+	}
+
+	std::array<uint32_t, 2> key_;
+	Block counter_;
+	Block output_{};
+	size_t position_ = output_.size();
+};
+
+using RandomGenerator = Philox4x32;
+
+//! Finalizer of SplitMix64, spreads close inputs over all bits.
+inline uint64_t MixHash(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+//! Uniform index in [0, count), multiply and shift with Lemire's rejection, so there is no division in the common case.
+inline uint32_t UniformIndex(RandomGenerator& generator, const uint32_t count)
+{
+	assert(count != 0);
+
+	uint64_t product = static_cast<uint64_t>(generator()) * count;
+	if (static_cast<uint32_t>(product) < count)
+	{
+		const uint32_t threshold = static_cast<uint32_t>(0 - count) % count;
+		while (static_cast<uint32_t>(product) < threshold)
+		{
+			product = static_cast<uint64_t>(generator()) * count;
+		}
+	}
+	return static_cast<uint32_t>(product >> 32);
+}
+
+//! Uniform value in [0, 1) with 32 random bits.
+inline double UniformUnit(RandomGenerator& generator)
+{
+	return static_cast<double>(generator()) * 0x1p-32;
+}
+
+enum class RandomStreamPurpose : uint32_t
+{
+	StartPopulation,
+	Sampling,
+	Crossingover,
+	Mutation,
+	Selection,
+	Offspring,
+};
+
+//! Hands out independent generators keyed by one seed.
+//! A stream depends only on (seed, purpose, generation, index), never on the thread that uses it,
+//! so a run is reproducible at any thread count.
+class RandomStreams
+{
+public:
+
+	explicit RandomStreams(const uint64_t seed)
+			: seed_(seed)
+	{}
+
+	uint64_t Seed() const
+	{
+		return seed_;
+	}
+
+	//! Independent streams for a sub-run, e.g. an island, mixed from the seed with SplitMix64.
+	RandomStreams Derive(const uint64_t sub_run) const
+	{
+		return RandomStreams(MixHash(seed_ + (sub_run + 1) * 0x9E3779B97F4A7C15ull));
+	}
+
+	RandomGenerator Stream(const RandomStreamPurpose purpose, const uint64_t generation, const uint64_t index) const
+	{
+		assert(generation <= std::numeric_limits<uint32_t>::max());
+		assert((index >> 48) == 0);
+
+		return RandomGenerator(
+				seed_,
+				static_cast<uint32_t>(index),
+				static_cast<uint32_t>((index >> 32) & 0xFFFF) | (static_cast<uint32_t>(purpose) << 16),
+				static_cast<uint32_t>(generation));
+	}
+
+private:
+	uint64_t seed_;
+};
+
+} // GeneticAlgorithm
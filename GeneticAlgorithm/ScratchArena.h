@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Numbered scratch buffers that keep their memory between generations.
+//! A caller uses the same slot for the same buffer every time, so after the first generation
+//! Buffer only hands the memory out again. Contents are not kept between calls.
+class ScratchArena
+{
+	using Word = uint64_t;
+
+public:
+
+	template <typename Type>
+	Type* Buffer(const size_t slot, const size_t count)
+	{
+		static_assert(std::is_trivially_copyable_v<Type> && std::is_trivially_destructible_v<Type>,
+				"Scratch buffers hold trivial types only");
+		static_assert(alignof(Type) <= alignof(std::max_align_t), "Scratch buffers are aligned as operator new");
+
+		if (slot >= buffers_.size())
+		{
+			buffers_.resize(slot + 1);
+		}
+
+		auto& buffer = buffers_[slot];
+		const size_t word_count = (count * sizeof(Type) + sizeof(Word) - 1) / sizeof(Word);
+		if (buffer.size() < word_count)
+		{
+			buffer.resize(word_count);
+		}
+		return reinterpret_cast<Type*>(buffer.data());
+	}
+
+private:
+	std::vector<std::vector<Word>> buffers_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <sys/mman.h>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Anonymous MAP_SHARED memory: processes forked after the region is created share its pages.
+class SharedMemoryRegion
+{
+public:
+
+	explicit SharedMemoryRegion(const size_t size)
+			: size_(size)
+	{
+		data_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (data_ == MAP_FAILED)
+		{
+			throw std::runtime_error("Can't map shared memory region");
+		}
+	}
+
+	SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+	SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+	void* Data() const
+	{
+		return data_;
+	}
+
+	size_t Size() const
+	{
+		return size_;
+	}
+
+	~SharedMemoryRegion()
+	{
+		::munmap(data_, size_);
+	}
+
+private:
+	void* data_;
+	size_t size_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Bounded lock-free queue for exactly one producer thread and one consumer thread.
+//! Slots are allocated once, TryPush and TryPop only copy into and out of them.
+template <typename Value>
+class SpscQueue
+{
+public:
+
+	explicit SpscQueue(const size_t capacity)
+			: slots_(capacity + 1)
+	{
+		if (capacity == 0)
+		{
+			throw std::runtime_error("Queue capacity must be positive");
+		}
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	//! Returns false when the queue is full, the value is not queued then.
+	bool TryPush(const Value& value)
+	{
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		const size_t next_tail = Next(tail);
+		if (next_tail == head_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		slots_[tail] = value;
+		tail_.store(next_tail, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(Value& value)
+	{
+		const size_t head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		value = slots_[head];
+		head_.store(Next(head), std::memory_order_release);
+		return true;
+	}
+
+private:
+
+	size_t Next(const size_t position) const
+	{
+		return position + 1 == slots_.size() ? 0 : position + 1;
+	}
+
+	std::vector<Value> slots_;
+	alignas(64) std::atomic<size_t> head_{0};
+	alignas(64) std::atomic<size_t> tail_{0};
+};
+
+} // GeneticAlgorithm
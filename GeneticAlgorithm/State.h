@@ -0,0 +1,25 @@
+#pragma once
+
+#include "stable.h"
+
+namespace GA
+{
+
+template <typename Genotype>
+using Population = std::vector<Genotype>;
+
+template <typename ScoreValue>
+using ScorePopulation = std::vector<ScoreValue>;
+
+//! Copies reuse the capacity of the target vectors, moves only take the buffers over.
+template <typename Genotype, typename ScoreValue>
+struct State
+{
+	Population<Genotype> current_population_;
+	ScorePopulation<ScoreValue> current_population_score_;
+};
+
+template <typename Genotype, typename ScoreValue>
+using States = std::vector<State<Genotype, ScoreValue>>;
+
+} // GeneticAlgorithm
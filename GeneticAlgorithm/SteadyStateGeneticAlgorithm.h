@@ -0,0 +1,438 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include "stable.h"
+#include "GeneticAlgorithm.h"
+
+namespace GA
+{
+
+//! Steady state engine without a barrier between generations. Every worker thread picks two parents
+//! by tournament, makes a child, scores it outside of any lock and puts it in place of the worst individual
+//! when the child is better, so a slow evaluation holds up only its own worker.
+//! A child is the crossingover of the parents with probability crossingover_part and a copy of the first one
+//! otherwise; copies are always mutated, crossingover children with probability mutation_part.
+//! Every population size children make an epoch, epochs take the place of generations for the limit,
+//! EndGeneration of the strategy, the convergence check, the sink and the iteration count of the mutation.
+//! Parents are picked under a shared lock, so workers only wait for each other to put children in.
+//! The statistics, the convergence check and the sink of an epoch run on a copy of the population
+//! outside of the population lock, the other workers keep making children meanwhile.
+//! With one thread a seed gives one result, with more threads the result depends on their timing.
+template <typename Strategy>
+class SteadyStateGeneticAlgorithm
+{
+	using Index = size_t;
+	using Indexes = std::vector<Index>;
+
+public:
+
+	using StrategyType = Strategy;
+	using Genotype = typename Strategy::GenotypeType;
+	using ScoreValue = typename Strategy::ValueType;
+
+	static_assert(IsGeneticAlgorithmStrategy<Strategy>::value, "Strategy doesn't provide the genetic operators");
+
+	explicit SteadyStateGeneticAlgorithm(
+			const std::shared_ptr<Strategy>& strategy,
+			const size_t thread_count = 1,
+			const size_t tournament_size = 2)
+			: strategy_(strategy)
+			, thread_count_(thread_count)
+			, tournament_size_(tournament_size)
+	{
+		if (!strategy)
+		{
+			throw std::runtime_error("Empty strategy");
+		}
+		if (thread_count == 0)
+		{
+			throw std::runtime_error("Thread count must be positive");
+		}
+		if (tournament_size == 0)
+		{
+			throw std::runtime_error("Tournament size must be positive");
+		}
+	}
+
+	size_t ThreadCount() const
+	{
+		return thread_count_;
+	}
+
+	//! limit is the epoch count, iteration_count_ of the result counts epochs.
+	template <bool IsSaveState = false, bool IsMeasuringTime = false>
+	GeneticAlgorithmResult<Genotype, ScoreValue> Calculation(
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit = 1000,
+			const uint64_t seed = std::random_device{}(),
+			const IStateSinkPtr<Genotype, ScoreValue>& sink = nullptr) const
+	{
+		std::chrono::steady_clock::time_point start_time;
+		if constexpr (IsMeasuringTime)
+		{
+			start_time = std::chrono::steady_clock::now();
+		}
+
+		GeneticAlgorithmResult<Genotype, ScoreValue> result;
+		result.seed_ = seed;
+		if constexpr (IsSaveState)
+		{
+			result.states_ = std::make_optional<States<Genotype, ScoreValue>>();
+		}
+
+		const RandomStreams streams(seed);
+		SharedPopulation shared;
+		Initialize(streams, shared);
+
+		if (limit != 0)
+		{
+			if constexpr (IsSaveState)
+			{
+				result.states_->push_back(shared.state_);
+			}
+			if (sink)
+			{
+				sink->Consume(0, shared.state_);
+			}
+
+			RunWorkers(shared,
+					[&](const size_t worker)
+					{
+						Work<IsSaveState>(worker, mutation_part, crossingover_part, limit, streams, sink, shared, result);
+					});
+		}
+
+		if (sink)
+		{
+			sink->Finish();
+		}
+
+		// Workers stop only at the end of an epoch, its copy is the final state without the children made later
+		result.final_state_ = limit != 0 ? std::move(shared.epoch_state_) : std::move(shared.state_);
+		result.iteration_count_ = shared.finished_epoch_;
+
+		if constexpr (IsMeasuringTime)
+		{
+			result.times_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start_time).count();
+		}
+		return result;
+	}
+
+private:
+
+	//! Population shared by the workers: state_, worst_heap_, child_count_ and epoch_ are guarded by
+	//! population_mutex_, the copy of the last epoch and its statistics by epoch_mutex_.
+	//! A worker takes epoch_mutex_ before it releases population_mutex_, so epochs are finished in order.
+	//! worst_heap_ is a max-heap of slot indexes by score, its top is the slot a better child takes.
+	struct SharedPopulation
+	{
+		std::shared_mutex population_mutex_;
+		State<Genotype, ScoreValue> state_;
+		Indexes worst_heap_;
+		size_t child_count_ = 0;
+		size_t epoch_ = 0;
+
+		std::mutex epoch_mutex_;
+		State<Genotype, ScoreValue> epoch_state_;
+		size_t finished_epoch_ = 0;
+		PopulationStatisticsAccumulator<ScoreValue> statistics_accumulator_;
+		PopulationStatistics<ScoreValue> statistics_;
+
+		std::atomic<bool> is_stopped_{false};
+	};
+
+	//! Creates the start population and scores it chunk by chunk on all workers.
+	void Initialize(const RandomStreams& streams, SharedPopulation& shared) const
+	{
+		auto start_generator = streams.Stream(RandomStreamPurpose::StartPopulation, 0, 0);
+		auto& state = shared.state_;
+		state.current_population_ = strategy_->CreateStartPopulation(start_generator);
+
+		const size_t population_size = state.current_population_.size();
+		if (population_size == 0 || population_size > std::numeric_limits<uint32_t>::max())
+		{
+			throw std::runtime_error("Steady state engine needs from 1 to 2^32 - 1 individuals");
+		}
+		state.current_population_score_.resize(population_size);
+
+		std::atomic<size_t> next_chunk{0};
+		const size_t chunk_count = (population_size + chunk_size_ - 1) / chunk_size_;
+		RunWorkers(shared,
+				[this, &state, &next_chunk, chunk_count, population_size](const size_t /*worker*/)
+				{
+					for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+					{
+						const size_t begin = chunk * chunk_size_;
+						const size_t end = std::min(begin + chunk_size_, population_size);
+						strategy_->FitnessFunctionBatch(
+								state.current_population_.data() + begin,
+								end - begin,
+								state.current_population_score_.data() + begin);
+					}
+				});
+
+		shared.worst_heap_.resize(population_size);
+		std::iota(shared.worst_heap_.begin(), shared.worst_heap_.end(), Index{0});
+		for (size_t position = population_size / 2; position-- > 0; )
+		{
+			SiftDown(shared, position);
+		}
+
+		UpdateStatistics(state.current_population_score_, shared);
+	}
+
+	template <bool IsSaveState>
+	void Work(
+			const size_t worker,
+			const double mutation_part,
+			const double crossingover_part,
+			const size_t limit,
+			const RandomStreams& streams,
+			const IStateSinkPtr<Genotype, ScoreValue>& sink,
+			SharedPopulation& shared,
+			GeneticAlgorithmResult<Genotype, ScoreValue>& result) const
+	{
+		const auto& population = shared.state_.current_population_;
+		const auto& scores = shared.state_.current_population_score_;
+		const size_t population_size = population.size();
+
+		Genotype first_parent{};
+		Genotype second_parent{};
+		Genotype child{};
+		ScoreValue first_score{};
+		ScoreValue second_score{};
+		ScoreValue child_score{};
+
+		// A worker takes a new stream every epoch, so a stream never runs out of counters
+		size_t epoch = 0;
+		auto generator = streams.Stream(RandomStreamPurpose::Offspring, epoch, worker);
+
+		while (!shared.is_stopped_.load(std::memory_order_relaxed))
+		{
+			const bool is_crossingover = UniformUnit(generator) < crossingover_part;
+			{
+				std::shared_lock<std::shared_mutex> lock(shared.population_mutex_);
+				if (shared.epoch_ != epoch)
+				{
+					epoch = shared.epoch_;
+					generator = streams.Stream(RandomStreamPurpose::Offspring, epoch, worker);
+				}
+
+				const Index first = Tournament(scores, generator);
+				first_parent = population[first];
+				first_score = scores[first];
+				if (is_crossingover)
+				{
+					const Index second = Tournament(scores, generator);
+					second_parent = population[second];
+					second_score = scores[second];
+				}
+			}
+
+			if (is_crossingover)
+			{
+				strategy_->CrossingoverInto(first_parent, first_score, second_parent, second_score, child, generator);
+			}
+			else
+			{
+				child = first_parent;
+			}
+			if (!is_crossingover || UniformUnit(generator) < mutation_part)
+			{
+				strategy_->MutationInPlace(child, epoch, generator);
+			}
+			strategy_->FitnessFunctionBatch(&child, 1, &child_score);
+
+			std::unique_lock<std::shared_mutex> lock(shared.population_mutex_);
+			if (shared.is_stopped_.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+
+			ReplaceWorst(shared, child, child_score);
+			if (++shared.child_count_ % population_size != 0)
+			{
+				continue;
+			}
+
+			const size_t finished_epoch = ++shared.epoch_;
+			std::lock_guard<std::mutex> epoch_lock(shared.epoch_mutex_);
+			// A worker that waited for the epoch before it may find the run already stopped at that one
+			if (shared.is_stopped_.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+			// Copying reuses the memory of the previous epoch, the rest of the epoch runs without the population lock
+			shared.epoch_state_ = shared.state_;
+			lock.unlock();
+			EndEpoch<IsSaveState>(finished_epoch, limit, sink, shared, result);
+		}
+	}
+
+	//! Called under epoch_mutex_ on the copy of the population after every population size children.
+	template <bool IsSaveState>
+	void EndEpoch(
+			const size_t epoch,
+			const size_t limit,
+			const IStateSinkPtr<Genotype, ScoreValue>& sink,
+			SharedPopulation& shared,
+			GeneticAlgorithmResult<Genotype, ScoreValue>& result) const
+	{
+		shared.finished_epoch_ = epoch;
+
+		// Workers keep scoring children meanwhile, the strategy must allow it, as the surrogate does
+		strategy_->EndGeneration();
+
+		const auto& state = shared.epoch_state_;
+		const auto previous_statistics = shared.statistics_;
+		UpdateStatistics(state.current_population_score_, shared);
+
+		const bool is_correct_result = strategy_->IsCorrectResult(
+				state.current_population_, state.current_population_score_, previous_statistics, shared.statistics_);
+		if (is_correct_result || epoch >= limit)
+		{
+			shared.is_stopped_.store(true, std::memory_order_relaxed);
+			return;
+		}
+
+		if constexpr (IsSaveState)
+		{
+			result.states_->push_back(state);
+		}
+		if (sink)
+		{
+			sink->Consume(epoch, state);
+		}
+	}
+
+	//! The child takes the slot of the worst individual when it has a lower score.
+	void ReplaceWorst(SharedPopulation& shared, const Genotype& child, const ScoreValue child_score) const
+	{
+		auto& scores = shared.state_.current_population_score_;
+		const Index worst = shared.worst_heap_.front();
+		if (!(child_score < scores[worst]))
+		{
+			return;
+		}
+
+		shared.state_.current_population_[worst] = child;
+		scores[worst] = child_score;
+		SiftDown(shared, 0);
+	}
+
+	static void SiftDown(SharedPopulation& shared, size_t position)
+	{
+		const auto& scores = shared.state_.current_population_score_;
+		auto& heap = shared.worst_heap_;
+		const size_t size = heap.size();
+		const Index slot = heap[position];
+
+		while (true)
+		{
+			size_t child = 2 * position + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && scores[heap[child]] < scores[heap[child + 1]])
+			{
+				++child;
+			}
+			if (!(scores[slot] < scores[heap[child]]))
+			{
+				break;
+			}
+
+			heap[position] = heap[child];
+			position = child;
+		}
+
+		heap[position] = slot;
+	}
+
+	//! The best of tournament_size_ individuals drawn with replacement, the earlier one wins a tie.
+	Index Tournament(const ScorePopulation<ScoreValue>& scores, RandomGenerator& generator) const
+	{
+		const uint32_t size = static_cast<uint32_t>(scores.size());
+		Index best = UniformIndex(generator, size);
+		for (size_t round = 1; round < tournament_size_; ++round)
+		{
+			const Index candidate = UniformIndex(generator, size);
+			best = scores[candidate] < scores[best] ? candidate : best;
+		}
+		return best;
+	}
+
+	//! Same chunks as the generational engine, so equal scores give equal statistics.
+	static void UpdateStatistics(const ScorePopulation<ScoreValue>& scores, SharedPopulation& shared)
+	{
+		const size_t chunk_count = (scores.size() + chunk_size_ - 1) / chunk_size_;
+		shared.statistics_accumulator_.Reset(chunk_count);
+		for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+		{
+			const size_t begin = chunk * chunk_size_;
+			shared.statistics_accumulator_.AddChunk(
+					chunk, scores.data(), begin, std::min(begin + chunk_size_, scores.size()));
+		}
+		shared.statistics_ = shared.statistics_accumulator_.Combine();
+	}
+
+	//! Runs function(worker) on thread_count_ threads, the first error stops the others and is rethrown.
+	template <typename WorkerFunction>
+	void RunWorkers(SharedPopulation& shared, const WorkerFunction& function) const
+	{
+		std::vector<std::exception_ptr> errors(thread_count_);
+		const auto run = [&shared, &function, &errors](const size_t worker)
+		{
+			try
+			{
+				function(worker);
+			}
+			catch (...)
+			{
+				errors[worker] = std::current_exception();
+				shared.is_stopped_.store(true, std::memory_order_relaxed);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(thread_count_ - 1);
+		for (size_t worker = 1; worker < thread_count_; ++worker)
+		{
+			threads.emplace_back(run, worker);
+		}
+		run(0);
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (const auto& error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	constexpr static size_t chunk_size_ = 1024;
+
+	std::shared_ptr<Strategy> strategy_;
+	size_t thread_count_;
+	size_t tournament_size_;
+};
+
+template <typename Genotype, typename Value>
+using SteadyStateGeneticAlgorithmPtr = std::shared_ptr<SteadyStateGeneticAlgorithm<IGeneticAlgorithmStrategy<Genotype, Value>>>;
+
+} // GeneticAlgorithm
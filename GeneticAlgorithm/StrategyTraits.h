@@ -0,0 +1,64 @@
+#pragma once
+
+#include "stable.h"
+#include "PopulationStatistics.h"
+#include "Random.h"
+#include "ScratchArena.h"
+
+namespace GA
+{
+
+//! Checks that Strategy provides everything BasicGeneticAlgorithm calls on it.
+//! Both IGeneticAlgorithmStrategy and concrete final strategies satisfy it.
+template <typename Strategy, typename = void>
+struct IsGeneticAlgorithmStrategy : std::false_type
+{};
+
+template <typename Strategy>
+struct IsGeneticAlgorithmStrategy<Strategy, std::void_t<
+		typename Strategy::GenotypeType,
+		typename Strategy::ValueType,
+		decltype(std::declval<const Strategy&>().CreateStartPopulation(std::declval<RandomGenerator&>())),
+		decltype(std::declval<const Strategy&>().MutationInPlace(
+				std::declval<typename Strategy::GenotypeType&>(),
+				size_t{},
+				std::declval<RandomGenerator&>())),
+		decltype(std::declval<const Strategy&>().CrossingoverInto(
+				std::declval<const typename Strategy::GenotypeType&>(),
+				std::declval<typename Strategy::ValueType>(),
+				std::declval<const typename Strategy::GenotypeType&>(),
+				std::declval<typename Strategy::ValueType>(),
+				std::declval<typename Strategy::GenotypeType&>(),
+				std::declval<RandomGenerator&>())),
+		decltype(std::declval<const Strategy&>().FitnessFunctionBatch(
+				std::declval<const typename Strategy::GenotypeType*>(),
+				size_t{},
+				std::declval<typename Strategy::ValueType*>())),
+		decltype(std::declval<const Strategy&>().IsIncrementalFitness()),
+		decltype(std::declval<const Strategy&>().EndGeneration()),
+		decltype(std::declval<const Strategy&>().IsCorrectResult(
+				std::declval<const std::vector<typename Strategy::GenotypeType>&>(),
+				std::declval<const std::vector<typename Strategy::ValueType>&>(),
+				std::declval<const PopulationStatistics<typename Strategy::ValueType>&>(),
+				std::declval<const PopulationStatistics<typename Strategy::ValueType>&>()))>>
+		: std::true_type
+{};
+
+//! Checks that Selector can turn the scores of Strategy into selection keys.
+template <typename Selector, typename Value, typename = void>
+struct IsSelectionFunction : std::false_type
+{};
+
+template <typename Selector, typename Value>
+struct IsSelectionFunction<Selector, Value, std::void_t<
+		decltype(std::declval<const Selector&>().Selection(
+				std::declval<const Value*>(),
+				size_t{},
+				std::declval<const PopulationStatistics<Value>&>(),
+				std::declval<RandomGenerator&>(),
+				std::declval<ScratchArena&>(),
+				std::declval<double*>()))>>
+		: std::true_type
+{};
+
+} // GeneticAlgorithm
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cmath>
+
+#include "stable.h"
+#include "IGeneticAlgorithmStrategy.h"
+#include "KnnSurrogate.h"
+#include "ThreadScratch.h"
+
+namespace GA
+{
+
+//! Sends only the evaluated_part of every batch with the best predicted scores to the fitness function
+//! of the wrapped strategy, the others keep their prediction, though never better than the worst
+//! evaluated score of the batch. The surrogate learns from every evaluation and is trained in EndGeneration,
+//! between generations, so the predictions of a generation don't depend on the threads.
+//! Until the surrogate has enough samples every genotype is evaluated. The other operators are passed through.
+template <typename Genotype, typename Value>
+class SurrogateFitnessStrategy final : public IGeneticAlgorithmStrategy<Genotype, Value>
+{
+	using Population = std::vector<Genotype>;
+	using ScorePopulation = std::vector<Value>;
+
+public:
+
+	SurrogateFitnessStrategy(
+			const IGeneticAlgorithmStrategyPtr<Genotype, Value>& strategy,
+			const KnnSurrogatePtr<Genotype, Value>& surrogate,
+			const double evaluated_part)
+			: strategy_(strategy)
+			, surrogate_(surrogate)
+			, evaluated_part_(evaluated_part)
+	{
+		if (!strategy_)
+		{
+			throw std::runtime_error("Empty strategy");
+		}
+		if (!surrogate_)
+		{
+			throw std::runtime_error("Empty surrogate");
+		}
+		if (!(evaluated_part > 0.0 && evaluated_part <= 1.0))
+		{
+			throw std::runtime_error("Evaluated part must be in (0, 1]");
+		}
+	}
+
+	Population CreateStartPopulation(RandomGenerator& generator) const override
+	{
+		return strategy_->CreateStartPopulation(generator);
+	}
+
+	void CreateStartGenotypes(RandomGenerator& generator, Genotype* genotypes, const size_t count) const override
+	{
+		strategy_->CreateStartGenotypes(generator, genotypes, count);
+	}
+
+	Genotype Mutation(
+			const Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const override
+	{
+		return strategy_->Mutation(genotype, iteration_count, generator);
+	}
+
+	Genotype Crossingover(
+			const Genotype& first_parent, const Value first_score,
+			const Genotype& second_parent, const Value second_score,
+			RandomGenerator& generator) const override
+	{
+		return strategy_->Crossingover(first_parent, first_score, second_parent, second_score, generator);
+	}
+
+	void MutationInPlace(
+			Genotype& genotype,
+			const size_t iteration_count,
+			RandomGenerator& generator) const override
+	{
+		strategy_->MutationInPlace(genotype, iteration_count, generator);
+	}
+
+	void CrossingoverInto(
+			const Genotype& first_parent, const Value first_score,
+			const Genotype& second_parent, const Value second_score,
+			Genotype& child,
+			RandomGenerator& generator) const override
+	{
+		strategy_->CrossingoverInto(first_parent, first_score, second_parent, second_score, child, generator);
+	}
+
+	Value FitnessFunction(const Genotype& genotype) const override
+	{
+		return strategy_->FitnessFunction(genotype);
+	}
+
+	void FitnessFunctionBatch(const Genotype* genotypes, const size_t count, Value* scores) const override
+	{
+		ThreadScratch<Scratch> scratch;
+		auto& predictions = scratch->predictions_;
+		predictions.resize(count);
+		if (count == 0 || !surrogate_->Predict(genotypes, count, predictions.data(), scratch->neighbours_))
+		{
+			strategy_->FitnessFunctionBatch(genotypes, count, scores);
+			surrogate_->Add(genotypes, scores, count);
+
+			SurrogateStatistics statistics;
+			statistics.evaluated_count_ = count;
+			surrogate_->Record(statistics);
+			return;
+		}
+
+		const size_t evaluated_count = std::clamp<size_t>(
+				static_cast<size_t>(std::ceil(evaluated_part_ * static_cast<double>(count))), 1, count);
+		auto& order = scratch->order_;
+		order.resize(count);
+		std::iota(order.begin(), order.end(), size_t{0});
+		std::nth_element(order.begin(), order.begin() + evaluated_count - 1, order.end(),
+				[&predictions](const size_t left, const size_t right)
+				{
+					return predictions[left] < predictions[right] || (predictions[left] == predictions[right] && left < right);
+				});
+
+		auto& evaluated_genotypes = scratch->evaluated_genotypes_;
+		auto& evaluated_scores = scratch->evaluated_scores_;
+		evaluated_genotypes.resize(evaluated_count);
+		evaluated_scores.resize(evaluated_count);
+		for (size_t position = 0; position < evaluated_count; ++position)
+		{
+			evaluated_genotypes[position] = genotypes[order[position]];
+		}
+		strategy_->FitnessFunctionBatch(evaluated_genotypes.data(), evaluated_count, evaluated_scores.data());
+		surrogate_->Add(evaluated_genotypes.data(), evaluated_scores.data(), evaluated_count);
+
+		SurrogateStatistics statistics;
+		statistics.evaluated_count_ = evaluated_count;
+		statistics.skipped_count_ = count - evaluated_count;
+		statistics.predicted_count_ = evaluated_count;
+
+		Value worst_score = evaluated_scores.front();
+		for (size_t position = 0; position < evaluated_count; ++position)
+		{
+			const size_t index = order[position];
+			scores[index] = evaluated_scores[position];
+			worst_score = worst_score < scores[index] ? scores[index] : worst_score;
+			statistics.absolute_error_sum_ += std::abs(static_cast<double>(scores[index] - predictions[index]));
+		}
+		for (size_t position = evaluated_count; position < count; ++position)
+		{
+			const size_t index = order[position];
+			scores[index] = worst_score < predictions[index] ? predictions[index] : worst_score;
+		}
+		surrogate_->Record(statistics);
+	}
+
+	//! Predicted scores must not be replaced by a whole population pass, the engine scores only changed genotypes.
+	bool IsIncrementalFitness() const override
+	{
+		return true;
+	}
+
+	void EndGeneration() const override
+	{
+		surrogate_->Train();
+		strategy_->EndGeneration();
+	}
+
+	bool IsCorrectResult(
+			const Population& population,
+			const ScorePopulation& score_population,
+			const PopulationStatistics<Value>& previous_statistics,
+			const PopulationStatistics<Value>& statistics) const override
+	{
+		return strategy_->IsCorrectResult(population, score_population, previous_statistics, statistics);
+	}
+
+	~SurrogateFitnessStrategy() override = default;
+
+private:
+
+	struct Scratch
+	{
+		ScorePopulation predictions_;
+		std::vector<size_t> order_;
+		typename KnnSurrogate<Genotype, Value>::Neighbours neighbours_;
+		Population evaluated_genotypes_;
+		ScorePopulation evaluated_scores_;
+	};
+
+	IGeneticAlgorithmStrategyPtr<Genotype, Value> strategy_;
+	KnnSurrogatePtr<Genotype, Value> surrogate_;
+	double evaluated_part_;
+};
+
+} // GeneticAlgorithm
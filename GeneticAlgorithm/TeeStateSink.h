@@ -0,0 +1,47 @@
+#pragma once
+
+#include "stable.h"
+#include "IStateSink.h"
+
+namespace GA
+{
+
+//! Hands every generation to several sinks in turn.
+template <typename Genotype, typename ScoreValue>
+class TeeStateSink final : public IStateSink<Genotype, ScoreValue>
+{
+public:
+
+	explicit TeeStateSink(const std::vector<IStateSinkPtr<Genotype, ScoreValue>>& sinks)
+			: sinks_(sinks)
+	{
+		for (const auto& sink : sinks_)
+		{
+			if (!sink)
+			{
+				throw std::runtime_error("Empty state sink");
+			}
+		}
+	}
+
+	void Consume(const size_t iteration, const State<Genotype, ScoreValue>& state) override
+	{
+		for (const auto& sink : sinks_)
+		{
+			sink->Consume(iteration, state);
+		}
+	}
+
+	void Finish() override
+	{
+		for (const auto& sink : sinks_)
+		{
+			sink->Finish();
+		}
+	}
+
+private:
+	std::vector<IStateSinkPtr<Genotype, ScoreValue>> sinks_;
+};
+
+} // GeneticAlgorithm
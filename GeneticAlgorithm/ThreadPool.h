@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Fixed set of worker threads reused across generations.
+//! ParallelFor splits [0, count) into chunks of chunk_size, the calling thread takes part in the work.
+//! The chunk boundaries depend only on count and chunk_size, never on the number of threads.
+//! The function is called through a plain pointer, so a call doesn't allocate.
+class ThreadPool
+{
+	using ChunkCall = void (*)(const void*, size_t, size_t);
+
+public:
+
+	explicit ThreadPool(const size_t thread_count)
+	{
+		if (thread_count == 0)
+		{
+			throw std::runtime_error("Thread pool needs at least one thread");
+		}
+
+		workers_.reserve(thread_count - 1);
+		for (size_t index = 1; index < thread_count; ++index)
+		{
+			workers_.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		start_condition_.notify_all();
+
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	size_t ThreadCount() const
+	{
+		return workers_.size() + 1;
+	}
+
+	template <typename ChunkFunction>
+	void ParallelFor(const size_t count, const size_t chunk_size, const ChunkFunction& function)
+	{
+		assert(chunk_size > 0);
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+		if (workers_.empty() || chunk_count == 1)
+		{
+			for (size_t begin = 0; begin < count; begin += chunk_size)
+			{
+				function(begin, std::min(begin + chunk_size, count));
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			function_ = &function;
+			call_ = [](const void* function, const size_t begin, const size_t end)
+			{
+				(*static_cast<const ChunkFunction*>(function))(begin, end);
+			};
+			count_ = count;
+			chunk_size_ = chunk_size;
+			chunk_count_ = chunk_count;
+			next_chunk_.store(0, std::memory_order_relaxed);
+			busy_workers_ = workers_.size();
+			error_ = nullptr;
+			++generation_;
+		}
+		start_condition_.notify_all();
+
+		RunChunks();
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		finish_condition_.wait(lock, [this]() { return busy_workers_ == 0; });
+		function_ = nullptr;
+
+		if (error_)
+		{
+			std::rethrow_exception(error_);
+		}
+	}
+
+private:
+
+	void WorkerLoop()
+	{
+		size_t seen_generation = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				start_condition_.wait(lock, [this, seen_generation]() { return stop_ || generation_ != seen_generation; });
+				if (stop_)
+				{
+					return;
+				}
+				seen_generation = generation_;
+			}
+
+			RunChunks();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				--busy_workers_;
+			}
+			finish_condition_.notify_one();
+		}
+	}
+
+	void RunChunks()
+	{
+		size_t chunk;
+		while ((chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed)) < chunk_count_)
+		{
+			const size_t begin = chunk * chunk_size_;
+			try
+			{
+				call_(function_, begin, std::min(begin + chunk_size_, count_));
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (!error_)
+				{
+					error_ = std::current_exception();
+				}
+			}
+		}
+	}
+
+	std::vector<std::thread> workers_;
+
+	std::mutex dispatch_mutex_;
+	std::mutex mutex_;
+	std::condition_variable start_condition_;
+	std::condition_variable finish_condition_;
+
+	const void* function_ = nullptr;
+	ChunkCall call_ = nullptr;
+	size_t count_ = 0;
+	size_t chunk_size_ = 1;
+	size_t chunk_count_ = 0;
+	std::atomic<size_t> next_chunk_{0};
+	size_t busy_workers_ = 0;
+	size_t generation_ = 0;
+	bool stop_ = false;
+	std::exception_ptr error_;
+};
+
+using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+
+} // GeneticAlgorithm
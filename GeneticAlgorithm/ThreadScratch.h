@@ -0,0 +1,50 @@
+#pragma once
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Scratch buffers of a const object shared by threads, kept per thread between calls,
+//! so after the first generation a call only reuses their memory.
+//! The buffers are moved out for the lifetime of a ThreadScratch and moved back by its destructor,
+//! a nested call on the same thread gets empty buffers instead of the ones in use.
+template <typename Scratch>
+class ThreadScratch
+{
+public:
+
+	ThreadScratch()
+			: scratch_(std::move(Kept()))
+	{}
+
+	ThreadScratch(const ThreadScratch&) = delete;
+	ThreadScratch& operator=(const ThreadScratch&) = delete;
+
+	Scratch& operator*()
+	{
+		return scratch_;
+	}
+
+	Scratch* operator->()
+	{
+		return &scratch_;
+	}
+
+	~ThreadScratch()
+	{
+		Kept() = std::move(scratch_);
+	}
+
+private:
+
+	static Scratch& Kept()
+	{
+		thread_local Scratch scratch;
+		return scratch;
+	}
+
+	Scratch scratch_;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "stable.h"
+
+namespace GA
+{
+
+//! Runs independent tasks of very different length on a fixed number of threads.
+//! Tasks are dealt round-robin into per-thread deques, a thread takes its own tasks from the back
+//! and, when its deque is empty, steals from the front of the others.
+class WorkStealingScheduler
+{
+public:
+
+	using Task = std::function<void()>;
+
+	explicit WorkStealingScheduler(const size_t thread_count)
+			: thread_count_(thread_count)
+	{
+		if (thread_count_ == 0)
+		{
+			throw std::runtime_error("Scheduler needs at least one thread");
+		}
+	}
+
+	size_t ThreadCount() const
+	{
+		return thread_count_;
+	}
+
+	//! Blocks until every task has finished, rethrows the first exception of a task.
+	void Run(std::vector<Task> tasks) const
+	{
+		std::vector<TaskQueue> queues(thread_count_);
+		for (size_t index = 0; index < tasks.size(); ++index)
+		{
+			queues[index % thread_count_].tasks_.push_back(std::move(tasks[index]));
+		}
+
+		std::mutex error_mutex;
+		std::exception_ptr error;
+
+		const auto worker = [&queues, &error_mutex, &error, this](const size_t thread_index)
+		{
+			Task task;
+			while (TakeTask(queues, thread_index, task))
+			{
+				try
+				{
+					task();
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(thread_count_ - 1);
+		for (size_t thread_index = 1; thread_index < thread_count_; ++thread_index)
+		{
+			threads.emplace_back(worker, thread_index);
+		}
+		worker(0);
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+private:
+
+	struct TaskQueue
+	{
+		std::mutex mutex_;
+		std::deque<Task> tasks_;
+	};
+
+	//! No task is added while Run works, so an empty pass over all the queues means the work is over.
+	bool TakeTask(std::vector<TaskQueue>& queues, const size_t thread_index, Task& task) const
+	{
+		{
+			TaskQueue& own = queues[thread_index];
+			std::lock_guard<std::mutex> lock(own.mutex_);
+			if (!own.tasks_.empty())
+			{
+				task = std::move(own.tasks_.back());
+				own.tasks_.pop_back();
+				return true;
+			}
+		}
+
+		for (size_t offset = 1; offset < queues.size(); ++offset)
+		{
+			TaskQueue& victim = queues[(thread_index + offset) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex_);
+			if (!victim.tasks_.empty())
+			{
+				task = std::move(victim.tasks_.front());
+				victim.tasks_.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	size_t thread_count_;
+};
+
+} // GeneticAlgorithm
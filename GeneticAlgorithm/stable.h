@@ -5,7 +5,9 @@
 #include <cassert>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <random>
-#include <memory>
+#include <stdexcept>
 #include <type_traits>
 #include <unordered_map>
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "../GeneticAlgorithm/AllocationCounter.h"
+
+//! Replaces the global allocation functions to count them, the memory still comes from malloc.
+//! The nothrow forms of the standard library call these ones.
+
+namespace
+{
+
+void* CountedAllocate(const std::size_t size)
+{
+	GA::allocation_counter.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size == 0 ? 1 : size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* CountedAllocate(const std::size_t size, const std::align_val_t alignment)
+{
+	GA::allocation_counter.fetch_add(1, std::memory_order_relaxed);
+	const auto align = static_cast<std::size_t>(alignment);
+	const std::size_t aligned_size = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+	if (void* pointer = std::aligned_alloc(align, aligned_size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(const std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](const std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+	return CountedAllocate(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+	return CountedAllocate(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
@@ -5,17 +5,21 @@
 #include "../GeneticAlgorithm/ISelectionFunction.h"
 
 template <typename Value>
-class ForwardSelectionFunction : public GA::ISelectionFunction<Value>
+class ForwardSelectionFunction final : public GA::ISelectionFunction<Value>
 {
-	using ScorePopulation = std::vector<Value>;
-
 public:
 
 	ForwardSelectionFunction() = default;
 
-	std::vector<double> Selection(const ScorePopulation& score_population) const override
+	void Selection(
+			const Value* scores,
+			const size_t count,
+			const GA::PopulationStatistics<Value>& /*statistics*/,
+			GA::RandomGenerator& /*generator*/,
+			GA::ScratchArena& /*arena*/,
+			double* keys) const override
 	{
-		return score_population;
+		std::copy(scores, scores + count, keys);
 	}
 
 	~ForwardSelectionFunction() override = default;
@@ -1,29 +1,113 @@
 #include "GeneticAlgorithmSolverFactory.h"
 
-#include "ForwardSelectionFunction.h"
-#include "RosenbrokFunctionStrategy.h"
+#include "../GeneticAlgorithm/CachedFitnessStrategy.h"
+#include "../GeneticAlgorithm/ProcessPoolFitnessStrategy.h"
+#include "../GeneticAlgorithm/SurrogateFitnessStrategy.h"
+#include "RosenbrokNdFunctionStrategy.h"
 
-GA::GeneticAlgorithmPtr<Point2d, double>
-GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
-		const std::string& function_name,
-		const std::string& selection_function_type_name,
-		const size_t genotype_size)
+GA::ISelectionFunctionPtr<double> GeneticAlgorithmSolverFactory::CreateSelectionFunction(
+		const std::string& selection_function_type_name)
 {
 	GA::ISelectionFunctionPtr<double> selection_function;
 	if (selection_function_type_name == "simple-forward")
 	{
 		selection_function = std::make_shared<ForwardSelectionFunction<double>>();
 	}
+	else if (selection_function_type_name == "tournament")
+	{
+		selection_function = std::make_shared<TournamentSelectionFunction<double>>();
+	}
+	else if (selection_function_type_name == "linear-rank")
+	{
+		selection_function = std::make_shared<LinearRankSelectionFunction<double>>();
+	}
+	else if (selection_function_type_name == "roulette")
+	{
+		selection_function = std::make_shared<RouletteSelectionFunction<double>>();
+	}
+	else if (selection_function_type_name == "stochastic-universal")
+	{
+		selection_function = std::make_shared<StochasticUniversalSelectionFunction<double>>();
+	}
 
+	if (!selection_function)
+	{
+		throw std::runtime_error("Can't create selection function, incorrect parameter: " + selection_function_type_name);
+	}
+	return selection_function;
+}
+
+namespace
+{
+
+GA::IGeneticAlgorithmStrategyPtr<Point2d, double> CreatePoint2dStrategy(
+		const std::string& function_name,
+		const size_t genotype_size,
+		const Point2dFitnessCachePtr& fitness_cache,
+		const SurrogateOptions& surrogate_options,
+		const GA::EvaluatorProcessPoolPtr& evaluator_pool)
+{
 	GA::IGeneticAlgorithmStrategyPtr<Point2d, double> strategy;
 	if (function_name == "rosenbrok")
 	{
 		strategy = std::make_shared<RosenbrokFunctionStrategy>(genotype_size);
 	}
 
-	if (!selection_function)
+	if (!strategy)
 	{
-		throw std::runtime_error("Can't create selection function, incorrect parameter: " + selection_function_type_name);
+		throw std::runtime_error("Can't create strategy, incorrect parameter: " + function_name);
+	}
+
+	if (evaluator_pool)
+	{
+		strategy = std::make_shared<GA::ProcessPoolFitnessStrategy<Point2d, double>>(strategy, evaluator_pool);
+	}
+	if (fitness_cache)
+	{
+		strategy = std::make_shared<GA::CachedFitnessStrategy<Point2d, double>>(strategy, fitness_cache);
+	}
+	// Outside of the cache, so the evaluated children are looked up before the fitness function runs
+	if (surrogate_options.surrogate_)
+	{
+		strategy = std::make_shared<GA::SurrogateFitnessStrategy<Point2d, double>>(
+				strategy, surrogate_options.surrogate_, surrogate_options.evaluated_part_);
+	}
+	return strategy;
+}
+
+} // namespace
+
+GA::GeneticAlgorithmPtr<Point2d, double>
+GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
+		const std::string& function_name,
+		const std::string& selection_function_type_name,
+		const size_t genotype_size,
+		const size_t thread_count,
+		const Point2dFitnessCachePtr& fitness_cache,
+		const SurrogateOptions& surrogate_options,
+		const GA::EvaluatorProcessPoolPtr& evaluator_pool)
+{
+	const auto& selection_function = CreateSelectionFunction(selection_function_type_name);
+	const auto& strategy = CreatePoint2dStrategy(
+			function_name, genotype_size, fitness_cache, surrogate_options, evaluator_pool);
+
+	return std::make_shared<GA::GeneticAlgorithm<Point2d, double>>(selection_function, strategy, thread_count);
+}
+
+template <typename Point>
+GA::GeneticAlgorithmPtr<Point, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver(
+		const std::string& function_name,
+		const std::string& selection_function_type_name,
+		const size_t genotype_size,
+		const size_t dimension,
+		const size_t thread_count)
+{
+	const auto& selection_function = CreateSelectionFunction(selection_function_type_name);
+
+	GA::IGeneticAlgorithmStrategyPtr<Point, double> strategy;
+	if (function_name == "rosenbrok")
+	{
+		strategy = std::make_shared<RosenbrokNdFunctionStrategy<Point>>(genotype_size, dimension);
 	}
 
 	if (!strategy)
@@ -31,5 +115,112 @@ GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
 		throw std::runtime_error("Can't create strategy, incorrect parameter: " + function_name);
 	}
 
-	return std::make_shared<GA::GeneticAlgorithm<Point2d, double>>(selection_function, strategy);
+	return std::make_shared<GA::GeneticAlgorithm<Point, double>>(selection_function, strategy, thread_count);
+}
+
+template GA::GeneticAlgorithmPtr<PointNd<4>, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<4>>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+template GA::GeneticAlgorithmPtr<PointNd<8>, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<8>>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+template GA::GeneticAlgorithmPtr<PointNd<10>, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<10>>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+template GA::GeneticAlgorithmPtr<PointNd<16>, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<16>>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+template GA::GeneticAlgorithmPtr<PointNd<32>, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<32>>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+template GA::GeneticAlgorithmPtr<PointNd<64>, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<64>>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+template GA::GeneticAlgorithmPtr<PointXd, double> GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointXd>(
+		const std::string&, const std::string&, size_t, size_t, size_t);
+
+SteadyStatePoint2dSolverPtr GeneticAlgorithmSolverFactory::CreateSteadyStatePoint2dSolver(
+		const std::string& function_name,
+		const size_t genotype_size,
+		const size_t thread_count,
+		const Point2dFitnessCachePtr& fitness_cache,
+		const GA::EvaluatorProcessPoolPtr& evaluator_pool)
+{
+	return std::make_shared<GA::SteadyStateGeneticAlgorithm<GA::IGeneticAlgorithmStrategy<Point2d, double>>>(
+			CreatePoint2dStrategy(function_name, genotype_size, fitness_cache, {}, evaluator_pool), thread_count);
+}
+
+MultiObjectivePoint2dSolverPtr GeneticAlgorithmSolverFactory::CreateMultiObjectivePoint2dSolver(
+		const std::string& function_name,
+		const size_t genotype_size,
+		const size_t thread_count)
+{
+	if (function_name != "rosenbrok")
+	{
+		throw std::runtime_error("Can't create multi-objective strategy, incorrect parameter: " + function_name);
+	}
+
+	return std::make_shared<GA::MultiObjectiveGeneticAlgorithm<GA::IMultiObjectiveStrategy<Point2d, 2>>>(
+			std::make_shared<RosenbrokDistanceStrategy>(genotype_size), thread_count);
+}
+
+OutOfCorePoint2dSolverPtr GeneticAlgorithmSolverFactory::CreateOutOfCorePoint2dSolver(
+		const std::string& function_name,
+		const size_t genotype_size,
+		const size_t thread_count,
+		const size_t block_size,
+		const GA::EvaluatorProcessPoolPtr& evaluator_pool)
+{
+	return std::make_shared<GA::OutOfCoreGeneticAlgorithm<GA::IGeneticAlgorithmStrategy<Point2d, double>>>(
+			CreatePoint2dStrategy(function_name, genotype_size, nullptr, {}, evaluator_pool), thread_count, block_size);
+}
+
+StaticRosenbrokSolverPtr GeneticAlgorithmSolverFactory::CreateStaticRosenbrokSolver(
+		const std::string& selection_function_type_name,
+		const size_t genotype_size,
+		const size_t thread_count)
+{
+	if (selection_function_type_name != "simple-forward")
+	{
+		throw std::runtime_error("Can't create static selection function, incorrect parameter: "
+				+ selection_function_type_name);
+	}
+
+	return std::make_shared<StaticRosenbrokSolver>(
+			std::make_shared<ForwardSelectionFunction<double>>(),
+			std::make_shared<RosenbrokFunctionStrategy>(genotype_size),
+			thread_count);
+}
+
+IslandPoint2dSolverPtr GeneticAlgorithmSolverFactory::CreateIslandPoint2dSolver(
+		const std::string& function_name,
+		const std::string& selection_function_type_name,
+		const size_t genotype_size,
+		const size_t island_count,
+		const GA::MigrationOptions& migration_options,
+		const size_t thread_count)
+{
+	std::vector<GA::GeneticAlgorithmPtr<Point2d, double>> islands(island_count);
+	for (auto& island : islands)
+	{
+		island = CreateGeneticAlgorithmPoint2dSolver(
+				function_name, selection_function_type_name, genotype_size, thread_count);
+	}
+
+	return std::make_shared<IslandPoint2dSolver>(islands, migration_options);
+}
+
+ProcessIslandPoint2dSolverPtr GeneticAlgorithmSolverFactory::CreateProcessIslandPoint2dSolver(
+		const std::string& function_name,
+		const std::string& selection_function_type_name,
+		const size_t genotype_size,
+		const size_t process_count,
+		const GA::MigrationOptions& migration_options,
+		const size_t thread_count)
+{
+	// Fails early in the coordinator instead of in every worker
+	CreateGeneticAlgorithmPoint2dSolver(function_name, selection_function_type_name, genotype_size);
+
+	return std::make_shared<ProcessIslandPoint2dSolver>(
+			[=](const size_t /*island*/)
+			{
+				return CreateGeneticAlgorithmPoint2dSolver(
+						function_name, selection_function_type_name, genotype_size, thread_count);
+			},
+			process_count,
+			migration_options);
 }
@@ -1,12 +1,160 @@
 #pragma once
 
+#include "../GeneticAlgorithm/EvaluatorProcessPool.h"
+#include "../GeneticAlgorithm/FitnessCache.h"
 #include "../GeneticAlgorithm/GeneticAlgorithm.h"
+#include "../GeneticAlgorithm/IslandGeneticAlgorithm.h"
+#include "../GeneticAlgorithm/KnnSurrogate.h"
+#include "../GeneticAlgorithm/MultiObjectiveGeneticAlgorithm.h"
+#include "../GeneticAlgorithm/OutOfCoreGeneticAlgorithm.h"
+#include "../GeneticAlgorithm/ProcessIslandGeneticAlgorithm.h"
+#include "../GeneticAlgorithm/SteadyStateGeneticAlgorithm.h"
+#include "ForwardSelectionFunction.h"
+#include "LinearRankSelectionFunction.h"
 #include "Point2d.h"
+#include "Point2dFeatures.h"
+#include "Point2dHash.h"
+#include "PointNd.h"
+#include "PointXd.h"
+#include "RosenbrokDistanceStrategy.h"
+#include "RosenbrokFunctionStrategy.h"
+#include "RouletteSelectionFunction.h"
+#include "StochasticUniversalSelectionFunction.h"
+#include "TournamentSelectionFunction.h"
+
+using StaticRosenbrokSolver = GA::BasicGeneticAlgorithm<RosenbrokFunctionStrategy, ForwardSelectionFunction<double>>;
+using StaticRosenbrokSolverPtr = std::shared_ptr<StaticRosenbrokSolver>;
+
+using IslandPoint2dSolver = GA::IslandGeneticAlgorithm<
+		GA::IGeneticAlgorithmStrategy<Point2d, double>,
+		GA::ISelectionFunction<double>>;
+using IslandPoint2dSolverPtr = std::shared_ptr<IslandPoint2dSolver>;
+
+using ProcessIslandPoint2dSolver = GA::ProcessIslandGeneticAlgorithm<
+		GA::IGeneticAlgorithmStrategy<Point2d, double>,
+		GA::ISelectionFunction<double>>;
+using ProcessIslandPoint2dSolverPtr = std::shared_ptr<ProcessIslandPoint2dSolver>;
+
+using SteadyStatePoint2dSolverPtr = GA::SteadyStateGeneticAlgorithmPtr<Point2d, double>;
+
+using MultiObjectivePoint2dSolverPtr = GA::MultiObjectiveGeneticAlgorithmPtr<Point2d, 2>;
+
+using OutOfCorePoint2dSolverPtr = GA::OutOfCoreGeneticAlgorithmPtr<Point2d, double>;
+using MappedPoint2dPopulation = GA::MappedPopulation<Point2d, double>;
+
+using Point2dFitnessCache = GA::FitnessCache<Point2d, double>;
+using Point2dFitnessCachePtr = std::shared_ptr<Point2dFitnessCache>;
+
+using Point2dSurrogate = GA::KnnSurrogate<Point2d, double>;
+using Point2dSurrogatePtr = std::shared_ptr<Point2dSurrogate>;
+
+//! Children scored by the fitness function when a surrogate pre-screens them.
+struct SurrogateOptions
+{
+	Point2dSurrogatePtr surrogate_;
+	double evaluated_part_ = 0.25;
+};
 
 struct GeneticAlgorithmSolverFactory
 {
+	//! simple-forward, tournament, linear-rank, roulette or stochastic-universal.
+	static GA::ISelectionFunctionPtr<double> CreateSelectionFunction(const std::string& selection_function_type_name);
+
+	//! With fitness_cache the strategy looks scores up in the cache before evaluating them,
+	//! with a surrogate it evaluates only the children with the best predicted scores,
+	//! with evaluator_pool the function is evaluated by its worker processes.
 	static GA::GeneticAlgorithmPtr<Point2d, double> CreateGeneticAlgorithmPoint2dSolver(
 			const std::string& function_name,
 			const std::string& selection_function_type_name,
-			const size_t genotype_size);
+			const size_t genotype_size,
+			const size_t thread_count = 1,
+			const Point2dFitnessCachePtr& fitness_cache = nullptr,
+			const SurrogateOptions& surrogate_options = {},
+			const GA::EvaluatorProcessPoolPtr& evaluator_pool = nullptr);
+
+	//! Single population solver over points of dimension coordinates, Point is PointNd<dimension> or PointXd.
+	template <typename Point>
+	static GA::GeneticAlgorithmPtr<Point, double> CreateGeneticAlgorithmPointNdSolver(
+			const std::string& function_name,
+			const std::string& selection_function_type_name,
+			const size_t genotype_size,
+			const size_t dimension,
+			const size_t thread_count = 1);
+
+	//! Calls function with the solver of CreateGeneticAlgorithmPointNdSolver for dimension:
+	//! 4, 8, 10, 16, 32 and 64 have PointNd solvers with compile time loops, other dimensions use PointXd.
+	template <typename Function>
+	static void WithPointNdSolver(
+			const std::string& function_name,
+			const std::string& selection_function_type_name,
+			const size_t genotype_size,
+			const size_t dimension,
+			const size_t thread_count,
+			Function&& function)
+	{
+		const auto call = [&](auto point)
+		{
+			using Point = decltype(point);
+			const auto& solver = CreateGeneticAlgorithmPointNdSolver<Point>(
+					function_name, selection_function_type_name, genotype_size, dimension, thread_count);
+			function(*solver);
+		};
+
+		switch (dimension)
+		{
+			case 4: return call(PointNd<4>{});
+			case 8: return call(PointNd<8>{});
+			case 10: return call(PointNd<10>{});
+			case 16: return call(PointNd<16>{});
+			case 32: return call(PointNd<32>{});
+			case 64: return call(PointNd<64>{});
+			default: return call(PointXd{});
+		}
+	}
+
+	//! Steady state solver, its workers pick parents by tournament, so it has no selection function.
+	static SteadyStatePoint2dSolverPtr CreateSteadyStatePoint2dSolver(
+			const std::string& function_name,
+			const size_t genotype_size,
+			const size_t thread_count = 1,
+			const Point2dFitnessCachePtr& fitness_cache = nullptr,
+			const GA::EvaluatorProcessPoolPtr& evaluator_pool = nullptr);
+
+	//! NSGA-II solver, rosenbrok minimizes the function and the squared distance to the origin together.
+	static MultiObjectivePoint2dSolverPtr CreateMultiObjectivePoint2dSolver(
+			const std::string& function_name,
+			const size_t genotype_size,
+			const size_t thread_count = 1);
+
+	//! Solver for populations in a population file, block_size individuals are processed together.
+	static OutOfCorePoint2dSolverPtr CreateOutOfCorePoint2dSolver(
+			const std::string& function_name,
+			const size_t genotype_size,
+			const size_t thread_count = 1,
+			const size_t block_size = 1 << 20,
+			const GA::EvaluatorProcessPoolPtr& evaluator_pool = nullptr);
+
+	//! Same solver with the strategy and selector bound at compile time.
+	static StaticRosenbrokSolverPtr CreateStaticRosenbrokSolver(
+			const std::string& selection_function_type_name,
+			const size_t genotype_size,
+			const size_t thread_count = 1);
+
+	//! island_count solvers with their own strategies, genotype_size is the size of one island.
+	static IslandPoint2dSolverPtr CreateIslandPoint2dSolver(
+			const std::string& function_name,
+			const std::string& selection_function_type_name,
+			const size_t genotype_size,
+			const size_t island_count,
+			const GA::MigrationOptions& migration_options,
+			const size_t thread_count = 1);
+
+	//! One island per worker process, the island solvers are created inside the workers.
+	static ProcessIslandPoint2dSolverPtr CreateProcessIslandPoint2dSolver(
+			const std::string& function_name,
+			const std::string& selection_function_type_name,
+			const size_t genotype_size,
+			const size_t process_count,
+			const GA::MigrationOptions& migration_options,
+			const size_t thread_count = 1);
 };
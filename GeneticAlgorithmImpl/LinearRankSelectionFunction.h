@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "../GeneticAlgorithm/ISelectionFunction.h"
+#include "SelectionCopies.h"
+
+//! Linear ranking (Baker): the best individual expects about selection_pressure copies, the worst 2 - selection_pressure,
+//! whatever the score scale is. Ranks are sampled with one random offset and equal steps as in
+//! stochastic universal sampling, so that part is a sequential pass; the order of double scores comes
+//! from an LSD radix sort, so a generation is O(n).
+template <typename Value>
+class LinearRankSelectionFunction final : public GA::ISelectionFunction<Value>
+{
+public:
+
+	explicit LinearRankSelectionFunction(const double selection_pressure = 2.0)
+			: selection_pressure_(selection_pressure)
+	{
+		if (!(selection_pressure_ >= 1.0 && selection_pressure_ <= 2.0))
+		{
+			throw std::runtime_error("Selection pressure of linear ranking must be in [1, 2]");
+		}
+	}
+
+	void Selection(
+			const Value* scores,
+			const size_t count,
+			const GA::PopulationStatistics<Value>& /*statistics*/,
+			GA::RandomGenerator& generator,
+			GA::ScratchArena& arena,
+			double* keys) const override
+	{
+		const uint32_t size = SelectionPopulationSize(count);
+
+		// Share of the ranks below x * size, counted from the worst: base * x + slope * x^2
+		const double base = 2.0 - selection_pressure_;
+		const double slope = selection_pressure_ - 1.0;
+		const double offset = GA::UniformUnit(generator);
+		const double pointer_count = static_cast<double>(size);
+
+		// Rank 0 is the worst score
+		const uint32_t* order = OrderFromWorst(scores, size, arena);
+		uint32_t* copies = arena.Buffer<uint32_t>(copies_slot_, size);
+		double previous_count = 0.0;
+		for (uint32_t rank = 0; rank < size; ++rank)
+		{
+			const double x = static_cast<double>(rank + 1) / pointer_count;
+			const double pointer_below = std::min(pointer_count,
+					std::max(previous_count, std::ceil(pointer_count * (base + slope * x) * x - offset)));
+			copies[order[rank]] = static_cast<uint32_t>(pointer_below - previous_count);
+			previous_count = pointer_below;
+		}
+
+		CopiesToKeys(copies, size, generator, keys);
+	}
+
+	~LinearRankSelectionFunction() override = default;
+
+private:
+
+	//! Stable: equal scores keep the index order. Small populations are sorted by comparisons,
+	//! the radix passes pay off only when the histograms are small against the population.
+	static const uint32_t* OrderFromWorst(const Value* scores, const size_t size, GA::ScratchArena& arena)
+	{
+		uint32_t* order = arena.Buffer<uint32_t>(order_slot_, size);
+		if constexpr (std::is_same_v<Value, double>)
+		{
+			if (size >= radix_sort_min_size_)
+			{
+				// Descending doubles as ascending unsigned keys
+				uint64_t* keys = arena.Buffer<uint64_t>(keys_slot_, size);
+				for (size_t index = 0; index < size; ++index)
+				{
+					uint64_t bits;
+					std::memcpy(&bits, &scores[index], sizeof(bits));
+					keys[index] = ~((bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63));
+					order[index] = static_cast<uint32_t>(index);
+				}
+				return RadixSort(size, keys, order,
+						arena.Buffer<uint64_t>(sorted_keys_slot_, size),
+						arena.Buffer<uint32_t>(sorted_order_slot_, size),
+						arena.Buffer<Histogram>(histograms_slot_, digit_count_));
+			}
+		}
+
+		// Ties are broken by the index as a stable sort would, std::stable_sort allocates its buffer on every call
+		std::iota(order, order + size, 0u);
+		std::sort(order, order + size,
+				[scores](const uint32_t left, const uint32_t right)
+				{
+					return scores[right] < scores[left] || (!(scores[left] < scores[right]) && left < right);
+				});
+		return order;
+	}
+
+	constexpr static size_t digit_bits_ = 11;
+	constexpr static size_t digit_count_ = (64 + digit_bits_ - 1) / digit_bits_;
+	constexpr static size_t bucket_count_ = size_t{1} << digit_bits_;
+
+	using Histogram = std::array<uint32_t, bucket_count_>;
+
+	//! Sorts keys with their indexes by digit_bits_ digits from the lowest, a digit that is the same
+	//! in all keys is skipped. The result is in one of the two buffer pairs, its order is returned.
+	static const uint32_t* RadixSort(
+			const size_t size,
+			uint64_t* keys,
+			uint32_t* order,
+			uint64_t* sorted_keys,
+			uint32_t* sorted_order,
+			Histogram* histograms)
+	{
+		constexpr uint64_t digit_mask = bucket_count_ - 1;
+
+		for (size_t digit = 0; digit < digit_count_; ++digit)
+		{
+			histograms[digit].fill(0);
+		}
+		for (size_t position = 0; position < size; ++position)
+		{
+			for (size_t digit = 0; digit < digit_count_; ++digit)
+			{
+				++histograms[digit][(keys[position] >> (digit * digit_bits_)) & digit_mask];
+			}
+		}
+
+		for (size_t digit = 0; digit < digit_count_; ++digit)
+		{
+			auto& histogram = histograms[digit];
+			const size_t shift = digit * digit_bits_;
+			if (histogram[(keys[0] >> shift) & digit_mask] == size)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (auto& bucket : histogram)
+			{
+				const uint32_t count = bucket;
+				bucket = offset;
+				offset += count;
+			}
+
+			for (size_t position = 0; position < size; ++position)
+			{
+				const uint32_t target = histogram[(keys[position] >> shift) & digit_mask]++;
+				sorted_keys[target] = keys[position];
+				sorted_order[target] = order[position];
+			}
+			std::swap(keys, sorted_keys);
+			std::swap(order, sorted_order);
+		}
+		return order;
+	}
+
+	constexpr static size_t radix_sort_min_size_ = 1 << 16;
+
+	constexpr static size_t copies_slot_ = 0;
+	constexpr static size_t order_slot_ = 1;
+	constexpr static size_t keys_slot_ = 2;
+	constexpr static size_t sorted_keys_slot_ = 3;
+	constexpr static size_t sorted_order_slot_ = 4;
+	constexpr static size_t histograms_slot_ = 5;
+
+	double selection_pressure_;
+};
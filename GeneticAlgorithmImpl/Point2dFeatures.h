@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../GeneticAlgorithm/GenotypeFeatures.h"
+#include "Point2d.h"
+
+namespace GA
+{
+
+template <>
+struct GenotypeFeatures<Point2d>
+{
+	static void Extract(const Point2d& genotype, double* features)
+	{
+		features[0] = genotype.x();
+		features[1] = genotype.y();
+	}
+
+	constexpr static size_t count_ = 2;
+};
+
+} // GeneticAlgorithm
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../GeneticAlgorithm/GenotypeHash.h"
+#include "Point2d.h"
+
+namespace GA
+{
+
+//! Points are equal when their coordinates have the same bits, so 0.0 and -0.0 are different genotypes.
+template <>
+struct GenotypeHash<Point2d>
+{
+	static uint64_t Hash(const Point2d& genotype)
+	{
+		return HashBytes(genotype);
+	}
+
+	static bool Equal(const Point2d& first, const Point2d& second)
+	{
+		return EqualBytes(first, second);
+	}
+};
+
+} // GeneticAlgorithm
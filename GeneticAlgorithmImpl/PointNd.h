@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//! Alignment of a point of dimension coordinates: the smallest power of two that holds it, at most a cache line,
+//! so a point never spans more cache lines than its size needs.
+constexpr size_t PointNdAlignment(const size_t dimension)
+{
+	size_t alignment = alignof(double);
+	while (alignment < 64 && alignment < dimension * sizeof(double))
+	{
+		alignment *= 2;
+	}
+	return alignment;
+}
+
+//! Point with Dimension coordinates stored contiguously. The dimension is a compile time constant,
+//! so loops over the coordinates have a fixed trip count and are unrolled and vectorized by the compiler.
+template <size_t Dimension>
+class alignas(PointNdAlignment(Dimension)) PointNd
+{
+	static_assert(Dimension > 0, "Point needs at least one coordinate");
+
+public:
+
+	PointNd() = default;
+
+	explicit PointNd(const size_t dimension)
+	{
+		Resize(dimension);
+	}
+
+	//! Points of a fixed dimension can't change their size, it is only checked.
+	static void Resize(const size_t dimension)
+	{
+		assert(dimension == Dimension);
+		(void)dimension;
+	}
+
+	constexpr static size_t Size()
+	{
+		return Dimension;
+	}
+
+	const double* data() const
+	{
+		return coordinates_;
+	}
+
+	double* data()
+	{
+		return coordinates_;
+	}
+
+	double operator[](const size_t index) const
+	{
+		return coordinates_[index];
+	}
+
+	double& operator[](const size_t index)
+	{
+		return coordinates_[index];
+	}
+
+private:
+	double coordinates_[Dimension]{};
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+//! Point with the dimension chosen at run time, for dimensions without a PointNd instantiation.
+//! Assigning to a point of the same dimension reuses its memory, so the next generation buffers
+//! of the engine don't allocate once they are filled.
+class PointXd
+{
+
+public:
+
+	PointXd() = default;
+
+	explicit PointXd(const size_t dimension) : coordinates_(dimension)
+	{}
+
+	void Resize(const size_t dimension)
+	{
+		coordinates_.resize(dimension);
+	}
+
+	size_t Size() const
+	{
+		return coordinates_.size();
+	}
+
+	const double* data() const
+	{
+		return coordinates_.data();
+	}
+
+	double* data()
+	{
+		return coordinates_.data();
+	}
+
+	double operator[](const size_t index) const
+	{
+		return coordinates_[index];
+	}
+
+	double& operator[](const size_t index)
+	{
+		return coordinates_[index];
+	}
+
+private:
+	std::vector<double> coordinates_;
+};
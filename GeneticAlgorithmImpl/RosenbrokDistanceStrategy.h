@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+
+#include "../GeneticAlgorithm/IMultiObjectiveStrategy.h"
+#include "Point2d.h"
+
+//! Two objectives over the plane: the Rosenbrock function and the squared distance to the origin.
+//! The first is 0 at (1, 1), the second at (0, 0), the Pareto front is the curve between them.
+class RosenbrokDistanceStrategy final : public GA::IMultiObjectiveStrategy<Point2d, 2>
+{
+	using Population = std::vector<Point2d>;
+
+public:
+
+	explicit RosenbrokDistanceStrategy(const size_t genotype_size)
+			: genotype_size_(genotype_size)
+	{}
+
+	Population CreateStartPopulation(GA::RandomGenerator& generator) const override
+	{
+		Population points(genotype_size_);
+		for (auto& point : points)
+		{
+			const double x = min_border_ + (max_border_ - min_border_) * GA::UniformUnit(generator);
+			const double y = min_border_ + (max_border_ - min_border_) * GA::UniformUnit(generator);
+			point = Point2d(x, y);
+		}
+		return points;
+	}
+
+	//! Moves the point by a uniform step that shrinks with the iteration count, as the single objective strategy does.
+	void MutationInPlace(
+			Point2d& genotype,
+			const size_t iteration_count,
+			GA::RandomGenerator& generator) const override
+	{
+		const double scale = 1.0 / static_cast<double>(iteration_count + 1);
+		const double low = min_border_ * scale;
+		const double width = (max_border_ - min_border_) * scale;
+		const double dx = low + width * GA::UniformUnit(generator);
+		const double dy = low + width * GA::UniformUnit(generator);
+		genotype = Point2d(genotype.x() + dx, genotype.y() + dy);
+	}
+
+	//! A random point of the segment between the parents, there is no better parent with several objectives.
+	void CrossingoverInto(
+			const Point2d& first_parent,
+			const Point2d& second_parent,
+			Point2d& child,
+			GA::RandomGenerator& generator) const override
+	{
+		const double weight = GA::UniformUnit(generator);
+		child = Point2d(
+				first_parent.x() + weight * (second_parent.x() - first_parent.x()),
+				first_parent.y() + weight * (second_parent.y() - first_parent.y()));
+	}
+
+	void ObjectivesBatch(const Point2d* genotypes, const size_t count, ObjectivesType* objectives) const override
+	{
+		for (size_t index = 0; index < count; ++index)
+		{
+			const double x = genotypes[index].x();
+			const double y = genotypes[index].y();
+			const double delta = y - x * x;
+			objectives[index] = {(1.0 - x) * (1.0 - x) + 100.0 * delta * delta, x * x + y * y};
+		}
+	}
+
+	~RosenbrokDistanceStrategy() override = default;
+
+private:
+	size_t genotype_size_;
+
+	const double min_border_ = -3.0;
+	const double max_border_ = 3.0;
+};
@@ -0,0 +1,116 @@
+#include "RosenbrokFunctionKernel.h"
+
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GA_ROSENBROK_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+static_assert(std::is_standard_layout_v<Point2d> && sizeof(Point2d) == 2 * sizeof(double),
+		"Kernels read Point2d as interleaved x, y pairs");
+
+using RosenbrokKernel = void (*)(const double*, size_t, double*);
+
+inline double RosenbrokValue(const double x, const double y)
+{
+	const double first_part = (1.0 - x) * (1.0 - x);
+	const double sqr_x = x * x;
+	const double second_part = 100.0 * (y - sqr_x) * (y - sqr_x);
+	return first_part + second_part;
+}
+
+void RosenbrokScalar(const double* xy, const size_t count, double* scores)
+{
+	for (size_t index = 0; index < count; ++index)
+	{
+		scores[index] = RosenbrokValue(xy[2 * index], xy[2 * index + 1]);
+	}
+}
+
+#ifdef GA_ROSENBROK_X86_KERNELS
+
+__attribute__((target("avx2")))
+void RosenbrokAvx2(const double* xy, const size_t count, double* scores)
+{
+	const __m256d one = _mm256_set1_pd(1.0);
+	const __m256d hundred = _mm256_set1_pd(100.0);
+
+	size_t index = 0;
+	for (; index + 4 <= count; index += 4)
+	{
+		const __m256d low = _mm256_loadu_pd(xy + 2 * index);
+		const __m256d high = _mm256_loadu_pd(xy + 2 * index + 4);
+
+		// x0 x2 x1 x3 and y0 y2 y1 y3
+		const __m256d x = _mm256_unpacklo_pd(low, high);
+		const __m256d y = _mm256_unpackhi_pd(low, high);
+
+		const __m256d one_minus_x = _mm256_sub_pd(one, x);
+		const __m256d first_part = _mm256_mul_pd(one_minus_x, one_minus_x);
+		const __m256d delta = _mm256_sub_pd(y, _mm256_mul_pd(x, x));
+		const __m256d second_part = _mm256_mul_pd(_mm256_mul_pd(hundred, delta), delta);
+		const __m256d score = _mm256_add_pd(first_part, second_part);
+
+		_mm256_storeu_pd(scores + index, _mm256_permute4x64_pd(score, 0xD8));
+	}
+
+	RosenbrokScalar(xy + 2 * index, count - index, scores + index);
+}
+
+__attribute__((target("avx512f")))
+void RosenbrokAvx512(const double* xy, const size_t count, double* scores)
+{
+	const __m512d one = _mm512_set1_pd(1.0);
+	const __m512d hundred = _mm512_set1_pd(100.0);
+	const __m512i x_lanes = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+	const __m512i y_lanes = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8)
+	{
+		const __m512d low = _mm512_loadu_pd(xy + 2 * index);
+		const __m512d high = _mm512_loadu_pd(xy + 2 * index + 8);
+
+		const __m512d x = _mm512_permutex2var_pd(low, x_lanes, high);
+		const __m512d y = _mm512_permutex2var_pd(low, y_lanes, high);
+
+		const __m512d one_minus_x = _mm512_sub_pd(one, x);
+		const __m512d first_part = _mm512_mul_pd(one_minus_x, one_minus_x);
+		const __m512d delta = _mm512_sub_pd(y, _mm512_mul_pd(x, x));
+		const __m512d second_part = _mm512_mul_pd(_mm512_mul_pd(hundred, delta), delta);
+
+		_mm512_storeu_pd(scores + index, _mm512_add_pd(first_part, second_part));
+	}
+
+	RosenbrokAvx2(xy + 2 * index, count - index, scores + index);
+}
+
+#endif
+
+RosenbrokKernel SelectKernel()
+{
+#ifdef GA_ROSENBROK_X86_KERNELS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return RosenbrokAvx512;
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return RosenbrokAvx2;
+	}
+#endif
+	return RosenbrokScalar;
+}
+
+} // namespace
+
+void RosenbrokFitnessBatch(const Point2d* points, const size_t count, double* scores)
+{
+	static const RosenbrokKernel kernel = SelectKernel();
+	kernel(reinterpret_cast<const double*>(points), count, scores);
+}
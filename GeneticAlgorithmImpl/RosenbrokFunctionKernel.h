@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Point2d.h"
+
+//! Scores count points, the widest kernel supported by the CPU is chosen at the first call.
+//! Every kernel gives the same bits as RosenbrokFunctionStrategy::FitnessFunction.
+void RosenbrokFitnessBatch(const Point2d* points, const size_t count, double* scores);
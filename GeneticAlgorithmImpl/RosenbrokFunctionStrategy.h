@@ -6,7 +6,8 @@
 #include "../GeneticAlgorithm/IGeneticAlgorithmStrategy.h"
 #include "Point2d.h"
 
-class RosenbrokFunctionStrategy : public GA::IGeneticAlgorithmStrategy<Point2d, double>
+//! Declared final so that a solver bound to this type calls and inlines the operators below directly.
+class RosenbrokFunctionStrategy final : public GA::IGeneticAlgorithmStrategy<Point2d, double>
 {
 	using Population = std::vector<Point2d>;
 	using ScorePopulation = std::vector<double >;
@@ -15,17 +16,47 @@ public:
 
 	explicit RosenbrokFunctionStrategy(const size_t genotype_size);
 
-	Population CreateStartPopulation() const override;
+	Population CreateStartPopulation(GA::RandomGenerator& generator) const override;
 
-	Point2d Mutation(const Point2d& genotype, const size_t iteration_count) const override;
+	void CreateStartGenotypes(GA::RandomGenerator& generator, Point2d* genotypes, const size_t count) const override;
+
+	Point2d Mutation(
+			const Point2d& genotype,
+			const size_t iteration_count,
+			GA::RandomGenerator& generator) const override;
 
 	Point2d Crossingover(
 			const Point2d& first_parent, const double first_score,
-			const Point2d& second_parent, const double second_score) const override;
+			const Point2d& second_parent, const double second_score,
+			GA::RandomGenerator& generator) const override;
+
+	void MutationInPlace(
+			Point2d& genotype,
+			const size_t iteration_count,
+			GA::RandomGenerator& generator) const override;
+
+	void CrossingoverInto(
+			const Point2d& first_parent, const double first_score,
+			const Point2d& second_parent, const double second_score,
+			Point2d& child,
+			GA::RandomGenerator& generator) const override;
 
 	double FitnessFunction(const Point2d& genotype) const override;
 
-	bool IsCorrectResult(const Population& population, const ScorePopulation& score_population) const override;
+	void FitnessFunctionBatch(const Point2d* genotypes, const size_t count, double* scores) const override;
+
+	//! The SIMD kernel scores the whole population faster than the changed part can be gathered.
+	bool IsIncrementalFitness() const override
+	{
+		return false;
+	}
+
+	//! Converged when the mean score has moved less than precise_ since the previous generation.
+	bool IsCorrectResult(
+			const Population& population,
+			const ScorePopulation& score_population,
+			const GA::PopulationStatistics<double>& previous_statistics,
+			const GA::PopulationStatistics<double>& statistics) const override;
 
 	~RosenbrokFunctionStrategy() override = default;
 
@@ -36,6 +67,35 @@ private:
 	const double max_border_ = 3.0;
 
 	constexpr static double precise_ = 1E-6;
-
-	mutable double last_mean_element_;
 };
+
+inline void RosenbrokFunctionStrategy::MutationInPlace(
+		Point2d& genotype,
+		const size_t iteration_count,
+		GA::RandomGenerator& generator) const
+{
+	std::uniform_real_distribution<> dis(min_border_ / (iteration_count + 1), max_border_ / (iteration_count + 1));
+
+	const double dx = dis(generator);
+	const double dy = dis(generator);
+	genotype = Point2d(genotype.x() + dx, genotype.y() + dy);
+}
+
+inline void RosenbrokFunctionStrategy::CrossingoverInto(
+		const Point2d& first_parent, const double first_score,
+		const Point2d& second_parent, const double second_score,
+		Point2d& child,
+		GA::RandomGenerator& /*generator*/) const
+{
+	child = first_score > second_score ? second_parent : first_parent;
+}
+
+inline double RosenbrokFunctionStrategy::FitnessFunction(const Point2d& genotype) const
+{
+	const double x = genotype.x();
+	const double y = genotype.y();
+	const double first_part = (1.0 - x) * (1.0 - x);
+	const double sqr_x = x * x;
+	const double second_part = 100.0 * (y - sqr_x) * (y - sqr_x);
+	return first_part + second_part;
+}
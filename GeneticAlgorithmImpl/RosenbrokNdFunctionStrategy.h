@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "../GeneticAlgorithm/IGeneticAlgorithmStrategy.h"
+#include "PointNd.h"
+#include "PointXd.h"
+
+//! Rosenbrock function of dimension coordinates: the sum of 100 (x[i + 1] - x[i]^2)^2 + (1 - x[i])^2,
+//! the minimum is 0 at (1, ..., 1). Genotype is PointNd<N>, whose loops have a compile time trip count,
+//! or PointXd. Sums run over independent lanes, so the compiler vectorizes them without reordering additions,
+//! and PointNd<N> and PointXd of the same dimension give the same bits.
+template <typename Genotype>
+class RosenbrokNdFunctionStrategy final : public GA::IGeneticAlgorithmStrategy<Genotype, double>
+{
+	using Population = std::vector<Genotype>;
+	using ScorePopulation = std::vector<double>;
+
+public:
+
+	RosenbrokNdFunctionStrategy(const size_t genotype_size, const size_t dimension)
+			: genotype_size_(genotype_size)
+			, dimension_(dimension)
+	{
+		if (dimension < 2)
+		{
+			throw std::runtime_error("Rosenbrock function needs at least 2 dimensions");
+		}
+		if constexpr (!std::is_same_v<Genotype, PointXd>)
+		{
+			if (dimension != Genotype::Size())
+			{
+				throw std::runtime_error("Point dimension differs from the strategy dimension");
+			}
+		}
+	}
+
+	Population CreateStartPopulation(GA::RandomGenerator& generator) const override
+	{
+		Population points(genotype_size_, Genotype(dimension_));
+		for (auto& point : points)
+		{
+			double* coordinates = point.data();
+			for (size_t index = 0; index < point.Size(); ++index)
+			{
+				coordinates[index] = min_border_ + (max_border_ - min_border_) * GA::UniformUnit(generator);
+			}
+		}
+		return points;
+	}
+
+	Genotype Mutation(
+			const Genotype& genotype,
+			const size_t iteration_count,
+			GA::RandomGenerator& generator) const override
+	{
+		Genotype mutant = genotype;
+		MutationInPlace(mutant, iteration_count, generator);
+		return mutant;
+	}
+
+	Genotype Crossingover(
+			const Genotype& first_parent, const double first_score,
+			const Genotype& second_parent, const double second_score,
+			GA::RandomGenerator& generator) const override
+	{
+		Genotype child(dimension_);
+		CrossingoverInto(first_parent, first_score, second_parent, second_score, child, generator);
+		return child;
+	}
+
+	//! Moves every coordinate by a uniform step that shrinks with the iteration count, as the 2d strategy does.
+	//! Random numbers are drawn for a block first, so the update of the block is one vectorized loop.
+	void MutationInPlace(
+			Genotype& genotype,
+			const size_t iteration_count,
+			GA::RandomGenerator& generator) const override
+	{
+		const double scale = 1.0 / static_cast<double>(iteration_count + 1);
+		const double low = min_border_ * scale;
+		const double width = (max_border_ - min_border_) * scale;
+
+		double* coordinates = genotype.data();
+		const size_t size = genotype.Size();
+		double offsets[block_size_];
+		for (size_t begin = 0; begin < size; begin += block_size_)
+		{
+			const size_t count = std::min(block_size_, size - begin);
+			for (size_t lane = 0; lane < count; ++lane)
+			{
+				offsets[lane] = GA::UniformUnit(generator);
+			}
+			for (size_t lane = 0; lane < count; ++lane)
+			{
+				coordinates[begin + lane] += low + width * offsets[lane];
+			}
+		}
+	}
+
+	//! The child lies on the segment from the better parent towards the other one, at most halfway.
+	void CrossingoverInto(
+			const Genotype& first_parent, const double first_score,
+			const Genotype& second_parent, const double second_score,
+			Genotype& child,
+			GA::RandomGenerator& generator) const override
+	{
+		const bool is_first_better = !(first_score > second_score);
+		const double* better = is_first_better ? first_parent.data() : second_parent.data();
+		const double* other = is_first_better ? second_parent.data() : first_parent.data();
+		const double weight = 0.5 * GA::UniformUnit(generator);
+
+		child.Resize(first_parent.Size());
+		double* coordinates = child.data();
+		for (size_t index = 0; index < child.Size(); ++index)
+		{
+			coordinates[index] = better[index] + weight * (other[index] - better[index]);
+		}
+	}
+
+	double FitnessFunction(const Genotype& genotype) const override
+	{
+		return Rosenbrock(genotype.data(), genotype.Size());
+	}
+
+	void FitnessFunctionBatch(const Genotype* genotypes, const size_t count, double* scores) const override
+	{
+		for (size_t index = 0; index < count; ++index)
+		{
+			scores[index] = Rosenbrock(genotypes[index].data(), genotypes[index].Size());
+		}
+	}
+
+	//! Converged when the mean score has moved less than precise_ since the previous generation.
+	bool IsCorrectResult(
+			const Population& /*population*/,
+			const ScorePopulation& /*score_population*/,
+			const GA::PopulationStatistics<double>& previous_statistics,
+			const GA::PopulationStatistics<double>& statistics) const override
+	{
+		return std::abs(previous_statistics.mean_ - statistics.mean_) < precise_;
+	}
+
+	~RosenbrokNdFunctionStrategy() override = default;
+
+private:
+
+	static double Term(const double coordinate, const double next_coordinate)
+	{
+		const double first_part = (1.0 - coordinate) * (1.0 - coordinate);
+		const double delta = next_coordinate - coordinate * coordinate;
+		return first_part + 100.0 * delta * delta;
+	}
+
+	static double Rosenbrock(const double* coordinates, const size_t dimension)
+	{
+		const size_t term_count = dimension - 1;
+		double sums[lane_count_] = {};
+
+		size_t index = 0;
+		for (; index + lane_count_ <= term_count; index += lane_count_)
+		{
+			for (size_t lane = 0; lane < lane_count_; ++lane)
+			{
+				sums[lane] += Term(coordinates[index + lane], coordinates[index + lane + 1]);
+			}
+		}
+		for (size_t lane = 0; index < term_count; ++index, ++lane)
+		{
+			sums[lane] += Term(coordinates[index], coordinates[index + 1]);
+		}
+
+		return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	}
+
+	size_t genotype_size_;
+	size_t dimension_;
+
+	const double min_border_ = -3.0;
+	const double max_border_ = 3.0;
+
+	constexpr static double precise_ = 1E-6;
+	constexpr static size_t lane_count_ = 4;
+	constexpr static size_t block_size_ = 16;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "../GeneticAlgorithm/ISelectionFunction.h"
+#include "SelectionCopies.h"
+
+//! Fitness proportional roulette. The wheel is a Walker alias table built by Vose's method in O(n),
+//! after that every parent costs one column, one coin and at most one more read.
+template <typename Value>
+class RouletteSelectionFunction final : public GA::ISelectionFunction<Value>
+{
+	//! Column of the table: keep column with probability_, take alias_ otherwise.
+	struct AliasColumn
+	{
+		double probability_;
+		uint32_t alias_;
+	};
+
+public:
+
+	RouletteSelectionFunction() = default;
+
+	void Selection(
+			const Value* scores,
+			const size_t count,
+			const GA::PopulationStatistics<Value>& statistics,
+			GA::RandomGenerator& generator,
+			GA::ScratchArena& arena,
+			double* keys) const override
+	{
+		const uint32_t size = SelectionPopulationSize(count);
+
+		AliasColumn* table = arena.Buffer<AliasColumn>(0, size);
+		BuildTable(scores, size, statistics, arena.Buffer<uint32_t>(1, size), table);
+
+		// Draws go in blocks, so the reads of the table for a block are independent of each other
+		uint32_t* copies = arena.Buffer<uint32_t>(2, size);
+		std::fill(copies, copies + size, 0);
+		uint32_t columns[block_size_];
+		double coins[block_size_];
+		for (size_t block_begin = 0; block_begin < size; block_begin += block_size_)
+		{
+			const size_t block_count = std::min<size_t>(block_size_, size - block_begin);
+			for (size_t lane = 0; lane < block_count; ++lane)
+			{
+				columns[lane] = GA::UniformIndex(generator, size);
+				coins[lane] = GA::UniformUnit(generator);
+			}
+			for (size_t lane = 0; lane < block_count; ++lane)
+			{
+				const AliasColumn& entry = table[columns[lane]];
+				columns[lane] = coins[lane] < entry.probability_ ? columns[lane] : entry.alias_;
+			}
+			for (size_t lane = 0; lane < block_count; ++lane)
+			{
+				++copies[columns[lane]];
+			}
+		}
+
+		CopiesToKeys(copies, size, generator, keys);
+	}
+
+	~RouletteSelectionFunction() override = default;
+
+private:
+
+	//! work is scratch space for size column numbers.
+	static void BuildTable(
+			const Value* scores,
+			const size_t size,
+			const GA::PopulationStatistics<Value>& statistics,
+			uint32_t* work,
+			AliasColumn* table)
+	{
+		const double weight_sum = (static_cast<double>(statistics.max_) - statistics.mean_) * static_cast<double>(size);
+		if (!(weight_sum > 0.0))
+		{
+			for (size_t column = 0; column < size; ++column)
+			{
+				table[column] = {1.0, static_cast<uint32_t>(column)};
+			}
+			return;
+		}
+
+		// Scaled so that the mean weight is 1, small columns are stacked at the front of the work list
+		// and large ones at the back
+		const double scale = static_cast<double>(size) / weight_sum;
+		size_t small_end = 0;
+		size_t large_begin = size;
+		for (size_t column = 0; column < size; ++column)
+		{
+			const double weight = FitnessWeight(scores[column], statistics) * scale;
+			table[column] = {weight, static_cast<uint32_t>(column)};
+			if (weight < 1.0)
+			{
+				work[small_end++] = static_cast<uint32_t>(column);
+			}
+			else
+			{
+				work[--large_begin] = static_cast<uint32_t>(column);
+			}
+		}
+
+		while (small_end != 0 && large_begin != size)
+		{
+			const uint32_t small = work[--small_end];
+			const uint32_t large = work[large_begin];
+
+			table[small].alias_ = large;
+			table[large].probability_ -= 1.0 - table[small].probability_;
+			if (table[large].probability_ < 1.0)
+			{
+				++large_begin;
+				work[small_end++] = large;
+			}
+		}
+
+		// Left over columns differ from 1 only by rounding
+		for (size_t position = 0; position < small_end; ++position)
+		{
+			table[work[position]].probability_ = 1.0;
+		}
+		for (size_t position = large_begin; position < size; ++position)
+		{
+			table[work[position]].probability_ = 1.0;
+		}
+	}
+
+	constexpr static size_t block_size_ = 256;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../GeneticAlgorithm/PopulationStatistics.h"
+#include "../GeneticAlgorithm/Random.h"
+
+//! Stochastic selectors draw as many parents as there are individuals and count the copies of every individual.
+//! The individuals with the fewest copies are replaced first, ties are broken by a random fraction,
+//! so the key is minus the copy count minus a value in [0, 1).
+inline void CopiesToKeys(const uint32_t* copies, const size_t count, GA::RandomGenerator& generator, double* keys)
+{
+	const uint64_t salt = (static_cast<uint64_t>(generator()) << 32) | generator();
+
+	for (size_t index = 0; index < count; ++index)
+	{
+		const double fraction = static_cast<double>(GA::MixHash(salt + index) >> 11) * 0x1p-53;
+		keys[index] = -(static_cast<double>(copies[index]) + fraction);
+	}
+}
+
+//! Fitness proportional weight for minimization: the distance to the worst score of the generation.
+template <typename Value>
+double FitnessWeight(const Value score, const GA::PopulationStatistics<Value>& statistics)
+{
+	return static_cast<double>(statistics.max_) - static_cast<double>(score);
+}
+
+inline uint32_t SelectionPopulationSize(const size_t size)
+{
+	if (size == 0 || size > std::numeric_limits<uint32_t>::max())
+	{
+		throw std::runtime_error("Selection needs from 1 to 2^32 - 1 individuals");
+	}
+	return static_cast<uint32_t>(size);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmath>
+
+#include "../GeneticAlgorithm/ISelectionFunction.h"
+#include "SelectionCopies.h"
+
+//! Stochastic universal sampling (Baker): fitness proportional like the roulette,
+//! but one random offset places all pointers at equal steps, so the copy count of an individual
+//! differs from its expectation by less than one. It is a single pass over the scores.
+template <typename Value>
+class StochasticUniversalSelectionFunction final : public GA::ISelectionFunction<Value>
+{
+public:
+
+	StochasticUniversalSelectionFunction() = default;
+
+	void Selection(
+			const Value* scores,
+			const size_t count,
+			const GA::PopulationStatistics<Value>& statistics,
+			GA::RandomGenerator& generator,
+			GA::ScratchArena& arena,
+			double* keys) const override
+	{
+		const uint32_t size = SelectionPopulationSize(count);
+		const double weight_sum = (static_cast<double>(statistics.max_) - statistics.mean_) * static_cast<double>(size);
+
+		uint32_t* copies = arena.Buffer<uint32_t>(0, size);
+		if (!(weight_sum > 0.0))
+		{
+			std::fill(copies, copies + size, 1);
+			CopiesToKeys(copies, size, generator, keys);
+			return;
+		}
+
+		// Pointer k is at (offset + k) * step, the pointers below cumulative are counted in units of step
+		const double inverse_step = static_cast<double>(size) / weight_sum;
+		const double offset = GA::UniformUnit(generator);
+		const double pointer_count = static_cast<double>(size);
+
+		double cumulative = 0.0;
+		double previous_count = 0.0;
+		for (size_t index = 0; index < size; ++index)
+		{
+			cumulative += FitnessWeight(scores[index], statistics);
+			const double pointer_below = std::min(pointer_count,
+					std::max(previous_count, std::ceil(cumulative * inverse_step - offset)));
+			copies[index] = static_cast<uint32_t>(pointer_below - previous_count);
+			previous_count = pointer_below;
+		}
+
+		CopiesToKeys(copies, size, generator, keys);
+	}
+
+	~StochasticUniversalSelectionFunction() override = default;
+};
@@ -0,0 +1,134 @@
+#include "SweepRunner.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "../GeneticAlgorithm/WorkStealingScheduler.h"
+#include "GeneticAlgorithmSolverFactory.h"
+
+std::vector<SweepJob> ReadSweepJobs(const std::string& file_name, const uint64_t seed)
+{
+	std::ifstream stream(file_name);
+	if (!stream)
+	{
+		throw std::runtime_error("Can't open sweep jobs file: " + file_name);
+	}
+
+	const GA::RandomStreams streams(seed);
+	std::vector<SweepJob> jobs;
+	std::string line;
+	size_t line_number = 0;
+	while (std::getline(stream, line))
+	{
+		++line_number;
+		if (line.find_first_not_of(" \t\r") == std::string::npos || line[line.find_first_not_of(" \t")] == '#')
+		{
+			continue;
+		}
+
+		std::istringstream line_stream(line);
+		SweepJob job{};
+		if (!(line_stream >> job.mutation_part_ >> job.crossingover_part_ >> job.genotype_size_))
+		{
+			throw std::runtime_error("Incorrect sweep job at line " + std::to_string(line_number));
+		}
+		if (!(line_stream >> job.seed_))
+		{
+			job.seed_ = streams.Derive(jobs.size()).Seed();
+		}
+		jobs.push_back(job);
+	}
+	return jobs;
+}
+
+std::vector<SweepJob> MakeSweepGrid(
+		const std::vector<double>& mutation_parts,
+		const std::vector<double>& crossingover_parts,
+		const std::vector<size_t>& genotype_sizes,
+		const size_t repeat_count,
+		const uint64_t seed)
+{
+	const GA::RandomStreams streams(seed);
+	std::vector<SweepJob> jobs;
+	for (const double mutation_part : mutation_parts)
+	{
+		for (const double crossingover_part : crossingover_parts)
+		{
+			for (const size_t genotype_size : genotype_sizes)
+			{
+				for (size_t repeat = 0; repeat < repeat_count; ++repeat)
+				{
+					jobs.push_back({mutation_part, crossingover_part, genotype_size, streams.Derive(jobs.size()).Seed()});
+				}
+			}
+		}
+	}
+	return jobs;
+}
+
+std::vector<SweepJobResult> RunSweep(
+		const std::vector<SweepJob>& jobs,
+		const std::string& function_name,
+		const std::string& selection_function_type_name,
+		const size_t limit,
+		const size_t thread_count,
+		const Point2dFitnessCachePtr& fitness_cache)
+{
+	std::vector<SweepJobResult> results(jobs.size());
+
+	std::vector<GA::WorkStealingScheduler::Task> tasks;
+	tasks.reserve(jobs.size());
+	for (size_t index = 0; index < jobs.size(); ++index)
+	{
+		tasks.emplace_back(
+				[&, index]()
+				{
+					const SweepJob& job = jobs[index];
+					const auto start_time = std::chrono::steady_clock::now();
+
+					const auto solver = GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
+							function_name, selection_function_type_name, job.genotype_size_, 1, fitness_cache);
+					const auto& result =
+							solver->Calculation(job.mutation_part_, job.crossingover_part_, limit, job.seed_);
+
+					const auto& scores = result.final_state_.current_population_score_;
+					const size_t best_index = std::min_element(scores.begin(), scores.end()) - scores.begin();
+
+					SweepJobResult& job_result = results[index];
+					job_result.job_ = job;
+					job_result.iteration_count_ = result.iteration_count_;
+					job_result.best_genotype_ = result.final_state_.current_population_[best_index];
+					job_result.best_score_ = scores[best_index];
+					job_result.mean_score_ = std::accumulate(scores.begin(), scores.end(), 0.0) / scores.size();
+					job_result.time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+							std::chrono::steady_clock::now() - start_time).count();
+				});
+	}
+
+	GA::WorkStealingScheduler(thread_count).Run(std::move(tasks));
+	return results;
+}
+
+void WriteSweepResults(std::ostream& stream, const std::vector<SweepJobResult>& results)
+{
+	stream << "job\tmutation_part\tcrossingover_part\tgenotype_size\tseed\titeration_count"
+			  "\tbest_x\tbest_y\tbest_score\tmean_score\ttime_ns\n";
+	for (size_t index = 0; index < results.size(); ++index)
+	{
+		const SweepJobResult& result = results[index];
+		stream
+				<< index << "\t"
+				<< result.job_.mutation_part_ << "\t"
+				<< result.job_.crossingover_part_ << "\t"
+				<< result.job_.genotype_size_ << "\t"
+				<< result.job_.seed_ << "\t"
+				<< result.iteration_count_ << "\t"
+				<< result.best_genotype_.x() << "\t"
+				<< result.best_genotype_.y() << "\t"
+				<< result.best_score_ << "\t"
+				<< result.mean_score_ << "\t"
+				<< result.time_ << "\n";
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "GeneticAlgorithmSolverFactory.h"
+
+struct SweepJob
+{
+	double mutation_part_;
+	double crossingover_part_;
+	size_t genotype_size_;
+	uint64_t seed_;
+};
+
+struct SweepJobResult
+{
+	SweepJob job_;
+	size_t iteration_count_ = 0;
+	Point2d best_genotype_{0.0, 0.0};
+	double best_score_ = 0.0;
+	double mean_score_ = 0.0;
+	long time_ = 0;
+};
+
+//! One job per line: mutation part, crossingover part, genotype size and an optional seed.
+//! Empty lines and lines starting with '#' are skipped, jobs without a seed get one derived from seed.
+std::vector<SweepJob> ReadSweepJobs(const std::string& file_name, const uint64_t seed);
+
+//! Every combination of the values, repeated repeat_count times with different seeds.
+std::vector<SweepJob> MakeSweepGrid(
+		const std::vector<double>& mutation_parts,
+		const std::vector<double>& crossingover_parts,
+		const std::vector<size_t>& genotype_sizes,
+		const size_t repeat_count,
+		const uint64_t seed);
+
+//! Runs every job as a separate single threaded Calculation on a work-stealing scheduler.
+//! All jobs share fitness_cache when it is given.
+std::vector<SweepJobResult> RunSweep(
+		const std::vector<SweepJob>& jobs,
+		const std::string& function_name,
+		const std::string& selection_function_type_name,
+		const size_t limit,
+		const size_t thread_count,
+		const Point2dFitnessCachePtr& fitness_cache = nullptr);
+
+void WriteSweepResults(std::ostream& stream, const std::vector<SweepJobResult>& results);
@@ -0,0 +1,124 @@
+#pragma once
+
+#if defined(__SSE2__)
+#define GA_TOURNAMENT_SELECTION_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "../GeneticAlgorithm/ISelectionFunction.h"
+#include "SelectionCopies.h"
+
+//! Every parent is the best of tournament_size individuals drawn with replacement.
+//! Tournaments run in blocks: the candidates of a round are drawn for the whole block,
+//! then compared lane by lane without branches.
+template <typename Value>
+class TournamentSelectionFunction final : public GA::ISelectionFunction<Value>
+{
+public:
+
+	explicit TournamentSelectionFunction(const size_t tournament_size = 2)
+			: tournament_size_(tournament_size)
+	{
+		if (tournament_size_ < 1)
+		{
+			throw std::runtime_error("Tournament size must be positive");
+		}
+	}
+
+	void Selection(
+			const Value* scores,
+			const size_t count,
+			const GA::PopulationStatistics<Value>& /*statistics*/,
+			GA::RandomGenerator& generator,
+			GA::ScratchArena& arena,
+			double* keys) const override
+	{
+		const uint32_t size = SelectionPopulationSize(count);
+
+		uint32_t* copies = arena.Buffer<uint32_t>(0, size);
+		std::fill(copies, copies + size, 0);
+
+		alignas(16) uint64_t best_indexes[block_size_];
+		alignas(16) Value best_scores[block_size_];
+		alignas(16) uint64_t indexes[block_size_];
+		alignas(16) Value candidate_scores[block_size_];
+
+		for (size_t block_begin = 0; block_begin < size; block_begin += block_size_)
+		{
+			const size_t block_count = std::min<size_t>(block_size_, size - block_begin);
+
+			for (size_t lane = 0; lane < block_count; ++lane)
+			{
+				best_indexes[lane] = GA::UniformIndex(generator, size);
+			}
+			for (size_t lane = 0; lane < block_count; ++lane)
+			{
+				best_scores[lane] = scores[best_indexes[lane]];
+			}
+
+			for (size_t round = 1; round < tournament_size_; ++round)
+			{
+				for (size_t lane = 0; lane < block_count; ++lane)
+				{
+					indexes[lane] = GA::UniformIndex(generator, size);
+				}
+				for (size_t lane = 0; lane < block_count; ++lane)
+				{
+					candidate_scores[lane] = scores[indexes[lane]];
+				}
+				KeepBetter(block_count, indexes, candidate_scores, best_indexes, best_scores);
+			}
+
+			for (size_t lane = 0; lane < block_count; ++lane)
+			{
+				++copies[best_indexes[lane]];
+			}
+		}
+
+		CopiesToKeys(copies, size, generator, keys);
+	}
+
+	~TournamentSelectionFunction() override = default;
+
+private:
+
+	//! The earlier candidate wins a tie.
+	static void KeepBetter(
+			const size_t count,
+			const uint64_t* indexes,
+			const Value* candidate_scores,
+			uint64_t* best_indexes,
+			Value* best_scores)
+	{
+		size_t lane = 0;
+#ifdef GA_TOURNAMENT_SELECTION_SSE2
+		if constexpr (std::is_same_v<Value, double>)
+		{
+			for (; lane + 2 <= count; lane += 2)
+			{
+				const __m128d candidate = _mm_load_pd(candidate_scores + lane);
+				const __m128d best = _mm_load_pd(best_scores + lane);
+				const __m128d is_better = _mm_cmplt_pd(candidate, best);
+				_mm_store_pd(best_scores + lane,
+						_mm_or_pd(_mm_and_pd(is_better, candidate), _mm_andnot_pd(is_better, best)));
+
+				const __m128i mask = _mm_castpd_si128(is_better);
+				const __m128i index = _mm_load_si128(reinterpret_cast<const __m128i*>(indexes + lane));
+				const __m128i best_index = _mm_load_si128(reinterpret_cast<const __m128i*>(best_indexes + lane));
+				_mm_store_si128(reinterpret_cast<__m128i*>(best_indexes + lane),
+						_mm_or_si128(_mm_and_si128(mask, index), _mm_andnot_si128(mask, best_index)));
+			}
+		}
+#endif
+		for (; lane < count; ++lane)
+		{
+			const bool is_better = candidate_scores[lane] < best_scores[lane];
+			best_scores[lane] = is_better ? candidate_scores[lane] : best_scores[lane];
+			best_indexes[lane] = is_better ? indexes[lane] : best_indexes[lane];
+		}
+	}
+
+	constexpr static size_t block_size_ = 256;
+
+	size_t tournament_size_;
+};
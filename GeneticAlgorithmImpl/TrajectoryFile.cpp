@@ -0,0 +1,188 @@
+#include "TrajectoryFile.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+constexpr char trajectory_magic[8] = {'G', 'A', 'T', 'R', 'A', 'J', '0', '1'};
+constexpr uint32_t trajectory_version = 1;
+constexpr size_t write_buffer_size = 1 << 20;
+
+uint64_t GenerationBlockSize(const uint64_t population_size)
+{
+	return sizeof(uint64_t) + 3 * population_size * sizeof(double);
+}
+
+} // namespace
+
+BinaryTrajectorySink::BinaryTrajectorySink(const std::string& file_name)
+		: file_(std::fopen(file_name.c_str(), "wb"))
+{
+	if (!file_)
+	{
+		throw std::runtime_error("Can't open trajectory file: " + file_name);
+	}
+	std::setvbuf(file_, nullptr, _IOFBF, write_buffer_size);
+
+	std::memcpy(header_.magic_, trajectory_magic, sizeof(trajectory_magic));
+	header_.version_ = trajectory_version;
+	header_.header_size_ = sizeof(TrajectoryHeader);
+
+	Write(&header_, sizeof(header_));
+}
+
+void BinaryTrajectorySink::Consume(const size_t iteration, const GA::State<Point2d, double>& state)
+{
+	const size_t population_size = state.current_population_.size();
+	if (offsets_.empty())
+	{
+		header_.population_size_ = population_size;
+	}
+	else if (header_.population_size_ != population_size)
+	{
+		throw std::runtime_error("Trajectory population size changed between generations");
+	}
+
+	coordinates_.resize(2 * population_size);
+	for (size_t index = 0; index < population_size; ++index)
+	{
+		coordinates_[index] = state.current_population_[index].x();
+		coordinates_[population_size + index] = state.current_population_[index].y();
+	}
+
+	offsets_.push_back(offset_);
+
+	const uint64_t block_iteration = iteration;
+	Write(&block_iteration, sizeof(block_iteration));
+	Write(coordinates_.data(), coordinates_.size() * sizeof(double));
+	Write(state.current_population_score_.data(), population_size * sizeof(double));
+}
+
+void BinaryTrajectorySink::Finish()
+{
+	if (!file_)
+	{
+		return;
+	}
+
+	header_.generation_count_ = offsets_.size();
+	header_.index_offset_ = offset_;
+	Write(offsets_.data(), offsets_.size() * sizeof(uint64_t));
+
+	if (std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&header_, sizeof(header_), 1, file_) != 1)
+	{
+		throw std::runtime_error("Can't write trajectory header");
+	}
+
+	const bool is_closed = std::fclose(file_) == 0;
+	file_ = nullptr;
+	if (!is_closed)
+	{
+		throw std::runtime_error("Can't close trajectory file");
+	}
+}
+
+BinaryTrajectorySink::~BinaryTrajectorySink()
+{
+	if (file_)
+	{
+		std::fclose(file_);
+	}
+}
+
+void BinaryTrajectorySink::Write(const void* data, const size_t size)
+{
+	if (size != 0 && std::fwrite(data, size, 1, file_) != 1)
+	{
+		throw std::runtime_error("Can't write trajectory file");
+	}
+	offset_ += size;
+}
+
+TrajectoryReader::TrajectoryReader(const std::string& file_name)
+{
+	const int descriptor = ::open(file_name.c_str(), O_RDONLY);
+	if (descriptor < 0)
+	{
+		throw std::runtime_error("Can't open trajectory file: " + file_name);
+	}
+
+	struct stat file_stat{};
+	if (::fstat(descriptor, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(TrajectoryHeader))
+	{
+		::close(descriptor);
+		throw std::runtime_error("Trajectory file is too short: " + file_name);
+	}
+
+	size_ = static_cast<size_t>(file_stat.st_size);
+	void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, descriptor, 0);
+	::close(descriptor);
+	if (mapping == MAP_FAILED)
+	{
+		throw std::runtime_error("Can't map trajectory file: " + file_name);
+	}
+	data_ = static_cast<const unsigned char*>(mapping);
+	header_ = reinterpret_cast<const TrajectoryHeader*>(data_);
+
+	const bool is_valid_header =
+			std::memcmp(header_->magic_, trajectory_magic, sizeof(trajectory_magic)) == 0
+			&& header_->version_ == trajectory_version
+			&& header_->header_size_ == sizeof(TrajectoryHeader);
+	const bool is_valid_index =
+			is_valid_header
+			&& header_->index_offset_ <= size_
+			&& header_->generation_count_ <= (size_ - header_->index_offset_) / sizeof(uint64_t);
+	if (!is_valid_index)
+	{
+		::munmap(const_cast<unsigned char*>(data_), size_);
+		throw std::runtime_error("Not a complete trajectory file: " + file_name);
+	}
+
+	offsets_ = reinterpret_cast<const uint64_t*>(data_ + header_->index_offset_);
+}
+
+size_t TrajectoryReader::PopulationSize() const
+{
+	return header_->population_size_;
+}
+
+size_t TrajectoryReader::GenerationCount() const
+{
+	return header_->generation_count_;
+}
+
+TrajectoryReader::Generation TrajectoryReader::GetGeneration(const size_t generation) const
+{
+	if (generation >= GenerationCount())
+	{
+		throw std::out_of_range("Trajectory generation out of range");
+	}
+
+	const uint64_t offset = offsets_[generation];
+	if (offset > size_ || GenerationBlockSize(PopulationSize()) > size_ - offset)
+	{
+		throw std::runtime_error("Trajectory generation block is out of the file");
+	}
+
+	const unsigned char* block = data_ + offset;
+	const auto* values = reinterpret_cast<const double*>(block + sizeof(uint64_t));
+
+	Generation result{};
+	std::memcpy(&result.iteration_, block, sizeof(uint64_t));
+	result.x_ = values;
+	result.y_ = values + PopulationSize();
+	result.score_ = values + 2 * PopulationSize();
+	return result;
+}
+
+TrajectoryReader::~TrajectoryReader()
+{
+	::munmap(const_cast<unsigned char*>(data_), size_);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../GeneticAlgorithm/IStateSink.h"
+#include "Point2d.h"
+
+//! Binary trajectory of a Point2d run.
+//! Layout: TrajectoryHeader, then one block per generation (uint64 iteration, x[N], y[N], score[N] as doubles),
+//! then generation_count_ uint64 block offsets. All values are in the byte order of the writing machine.
+struct TrajectoryHeader
+{
+	char magic_[8];
+	uint32_t version_;
+	uint32_t header_size_;
+	uint64_t population_size_;
+	uint64_t generation_count_;
+	uint64_t index_offset_;
+	uint64_t reserved_[3];
+};
+
+static_assert(sizeof(TrajectoryHeader) == 64, "Trajectory header must stay 64 bytes");
+
+//! Writes generations in the binary trajectory format as they come, the header is completed in Finish.
+class BinaryTrajectorySink final : public GA::IStateSink<Point2d, double>
+{
+public:
+
+	explicit BinaryTrajectorySink(const std::string& file_name);
+
+	void Consume(const size_t iteration, const GA::State<Point2d, double>& state) override;
+
+	void Finish() override;
+
+	~BinaryTrajectorySink() override;
+
+private:
+
+	void Write(const void* data, const size_t size);
+
+	std::FILE* file_ = nullptr;
+	TrajectoryHeader header_{};
+	uint64_t offset_ = 0;
+	std::vector<uint64_t> offsets_;
+	std::vector<double> coordinates_;
+};
+
+//! Read-only memory mapped trajectory, any generation is available without parsing the others.
+class TrajectoryReader
+{
+public:
+
+	struct Generation
+	{
+		uint64_t iteration_;
+		const double* x_;
+		const double* y_;
+		const double* score_;
+	};
+
+	explicit TrajectoryReader(const std::string& file_name);
+
+	TrajectoryReader(const TrajectoryReader&) = delete;
+	TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+	size_t PopulationSize() const;
+
+	size_t GenerationCount() const;
+
+	Generation GetGeneration(const size_t generation) const;
+
+	~TrajectoryReader();
+
+private:
+	const unsigned char* data_ = nullptr;
+	size_t size_ = 0;
+	const TrajectoryHeader* header_ = nullptr;
+	const uint64_t* offsets_ = nullptr;
+};
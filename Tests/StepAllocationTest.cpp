@@ -0,0 +1,81 @@
+#include <iostream>
+
+#include "../GeneticAlgorithm/AllocationCounter.h"
+#include "../GeneticAlgorithmImpl/GeneticAlgorithmSolverFactory.h"
+
+//! Once the workspace has grown to the population size, Step must not allocate:
+//! runs a few generations to warm it up and counts the allocations of the following ones.
+
+namespace
+{
+
+constexpr size_t population_size = 5000;
+constexpr size_t warm_up_generation_count = 3;
+constexpr size_t checked_generation_count = 10;
+
+template <typename Solver>
+uint64_t CountStepAllocations(const Solver& solver)
+{
+    using Genotype = typename Solver::Genotype;
+
+    const GA::RandomStreams streams(7);
+    GA::State<Genotype, double> state;
+    typename Solver::Workspace workspace;
+    solver.Initialize(streams, state, workspace);
+
+    size_t generation = 0;
+    for (; generation < warm_up_generation_count; ++generation)
+    {
+        solver.Step(0.3, 0.4, generation, streams, state, workspace);
+    }
+
+    const uint64_t allocation_start = GA::AllocationCount();
+    for (; generation < warm_up_generation_count + checked_generation_count; ++generation)
+    {
+        solver.Step(0.3, 0.4, generation, streams, state, workspace);
+    }
+    return GA::AllocationCount() - allocation_start;
+}
+
+bool Check(const std::string& name, const uint64_t allocation_count)
+{
+    if (allocation_count != 0)
+    {
+        std::cerr << "FAILED " << name << ": " << allocation_count << " allocations after warm-up" << std::endl;
+        return false;
+    }
+    std::cout << "ok " << name << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<std::string> selection_function_types = {
+            "simple-forward", "tournament", "linear-rank", "roulette", "stochastic-universal"};
+    const std::vector<size_t> thread_counts = {1, 3};
+
+    bool is_passed = true;
+    for (const size_t thread_count : thread_counts)
+    {
+        const std::string suffix = " (" + std::to_string(thread_count) + " threads)";
+        for (const auto& selection_function_type : selection_function_types)
+        {
+            const auto& solver = GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
+                    "rosenbrok", selection_function_type, population_size, thread_count);
+            is_passed &= Check("point2d " + selection_function_type + suffix, CountStepAllocations(*solver));
+
+            // PointNd strategies score only the changed individuals
+            const auto& nd_solver = GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPointNdSolver<PointNd<4>>(
+                    "rosenbrok", selection_function_type, population_size, 4, thread_count);
+            is_passed &= Check("point4d " + selection_function_type + suffix, CountStepAllocations(*nd_solver));
+        }
+
+        const auto& static_solver = GeneticAlgorithmSolverFactory::CreateStaticRosenbrokSolver(
+                "simple-forward", population_size, thread_count);
+        is_passed &= Check("static simple-forward" + suffix, CountStepAllocations(*static_solver));
+    }
+
+    return is_passed ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include <boost/program_options.hpp>
+
+#include "../GeneticAlgorithm/EvaluatorProtocol.h"
+#include "../GeneticAlgorithmImpl/Point2d.h"
+#include "../GeneticAlgorithmImpl/RosenbrokFunctionKernel.h"
+
+namespace po = boost::program_options;
+
+//! Stub worker of an EvaluatorProcessPool: scores Point2d requests from standard input with the Rosenbrock function.
+int main(int argc, char* argv[])
+{
+    po::options_description desc("Options");
+    desc.add_options()
+            ("help", "Print help messages")
+            ("delay-microseconds", po::value<size_t>(), "Sleep for every genotype, stands for an expensive fitness function")
+            ("crash-after", po::value<size_t>(), "Abort after answering this many requests, to try worker restarts");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help"))
+        {
+            std::cerr << "Rosenbrock evaluator worker, talks over standard input and output" << std::endl << desc << std::endl;
+            return 0;
+        }
+        po::notify(vm);
+
+        const auto delay = std::chrono::microseconds(vm.count("delay-microseconds")
+                ? vm["delay-microseconds"].as<size_t>() : 0);
+        const size_t crash_after = vm.count("crash-after")
+                ? vm["crash-after"].as<size_t>() : 0;
+
+        size_t request_count = 0;
+        GA::ServeEvaluatorRequests<Point2d, double>(STDIN_FILENO, STDOUT_FILENO,
+                [&](const Point2d* genotypes, const size_t count, double* scores)
+                {
+                    if (crash_after != 0 && request_count++ == crash_after)
+                    {
+                        std::abort();
+                    }
+                    if (delay.count() != 0)
+                    {
+                        std::this_thread::sleep_for(delay * count);
+                    }
+                    RosenbrokFitnessBatch(genotypes, count, scores);
+                });
+    }
+    catch (const po::error& program_option)
+    {
+        std::cerr << "ERROR: " << program_option.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return -1;
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "ERROR: " << error.what() << std::endl;
+        return -2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+
+#include "../GeneticAlgorithm/AllocationCounter.h"
+#include "../GeneticAlgorithmImpl/GeneticAlgorithmSolverFactory.h"
+
+namespace po = boost::program_options;
+
+//! Opens the phases of one generation of the compile time bound Rosenbrock solver to the benchmark.
+class PhaseProbe : public StaticRosenbrokSolver
+{
+public:
+
+    using StaticRosenbrokSolver::StaticRosenbrokSolver;
+    using StaticRosenbrokSolver::ApplyFitnessFuntionToPopulation;
+    using StaticRosenbrokSolver::ApplyMutationToPopulation;
+    using StaticRosenbrokSolver::GetSurviveDistributionPopulation;
+    using StaticRosenbrokSolver::Crossingover;
+};
+
+struct BenchmarkOptions
+{
+    double mutation_part_ = 0.3;
+    double crossingover_part_ = 0.2;
+    size_t repetition_count_ = 3;
+    size_t generation_count_ = 10;
+    uint64_t seed_ = 42;
+};
+
+//! Nanoseconds of every repetition, sorted, and the fewest allocations made by one repetition.
+struct Measurement
+{
+    std::vector<long> times_;
+    uint64_t min_allocation_count_ = std::numeric_limits<uint64_t>::max();
+
+    long Min() const
+    {
+        return times_.front();
+    }
+
+    long Median() const
+    {
+        return times_[times_.size() / 2];
+    }
+
+    long Mean() const
+    {
+        return std::accumulate(times_.begin(), times_.end(), 0L) / static_cast<long>(times_.size());
+    }
+};
+
+template <typename Function>
+Measurement Measure(const size_t repetition_count, Function&& function)
+{
+    Measurement measurement;
+    measurement.times_.reserve(repetition_count);
+    for (size_t repetition = 0; repetition < repetition_count; ++repetition)
+    {
+        const uint64_t allocation_start = GA::AllocationCount();
+        const auto start = std::chrono::steady_clock::now();
+        function(repetition);
+        const auto finish = std::chrono::steady_clock::now();
+        measurement.times_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+        measurement.min_allocation_count_ = std::min(
+                measurement.min_allocation_count_, GA::AllocationCount() - allocation_start);
+    }
+    std::sort(measurement.times_.begin(), measurement.times_.end());
+    return measurement;
+}
+
+template <typename Type>
+std::vector<Type> ParseList(const std::string& text)
+{
+    std::vector<Type> values;
+    std::istringstream stream(text);
+    std::string value;
+    while (std::getline(stream, value, ','))
+    {
+        values.push_back(boost::lexical_cast<Type>(value));
+    }
+    if (values.empty())
+    {
+        throw std::runtime_error("Empty list: " + text);
+    }
+    return values;
+}
+
+void WriteMeasurement(std::ostream& stream, const Measurement& measurement)
+{
+    stream << "\"min_ns\": " << measurement.Min()
+           << ", \"median_ns\": " << measurement.Median()
+           << ", \"mean_ns\": " << measurement.Mean()
+           << ", \"min_allocations\": " << measurement.min_allocation_count_;
+}
+
+//! Every phase runs on the population left by the previous repetitions, as it does inside the generation loop.
+void BenchmarkPhases(
+        std::ostream& stream,
+        bool& is_first,
+        const size_t population_size,
+        const size_t thread_count,
+        const BenchmarkOptions& options)
+{
+    const PhaseProbe probe(
+            std::make_shared<ForwardSelectionFunction<double>>(),
+            std::make_shared<RosenbrokFunctionStrategy>(population_size),
+            thread_count);
+
+    const GA::RandomStreams streams(options.seed_);
+    GA::State<Point2d, double> state;
+    PhaseProbe::Workspace workspace;
+    probe.Initialize(streams, state, workspace);
+
+    const size_t crossingover_count = static_cast<size_t>(population_size * options.crossingover_part_);
+    const size_t not_crossingover_count = population_size - crossingover_count;
+    const size_t mutation_count = static_cast<size_t>(options.mutation_part_ * population_size);
+
+    workspace.changed_.Resize(population_size);
+    std::vector<GA::Population<Point2d>::iterator> sampler(mutation_count);
+
+    std::vector<std::pair<const char*, Measurement>> phases;
+    phases.emplace_back("fitness", Measure(options.repetition_count_,
+            [&](size_t)
+            {
+                probe.ApplyFitnessFuntionToPopulation(state, workspace);
+            }));
+    phases.emplace_back("selection_and_ranking", Measure(options.repetition_count_,
+            [&](const size_t repetition)
+            {
+                probe.GetSurviveDistributionPopulation(
+                        not_crossingover_count, state,
+                        streams.Stream(GA::RandomStreamPurpose::Selection, repetition, 0), workspace);
+            }));
+    phases.emplace_back("crossingover", Measure(options.repetition_count_,
+            [&](const size_t repetition)
+            {
+                probe.Crossingover(repetition, streams, state, workspace);
+            }));
+    phases.emplace_back("mutation", Measure(options.repetition_count_,
+            [&](const size_t repetition)
+            {
+                probe.ApplyMutationToPopulation(options.mutation_part_, repetition, streams, state, workspace);
+            }));
+    phases.emplace_back("sample_iterator", Measure(options.repetition_count_,
+            [&](const size_t repetition)
+            {
+                GA::sample_iterator(state.current_population_.begin(), state.current_population_.end(),
+                        sampler.begin(), mutation_count,
+                        streams.Stream(GA::RandomStreamPurpose::Sampling, repetition, 0));
+            }));
+    phases.emplace_back("generation", Measure(options.repetition_count_,
+            [&](const size_t repetition)
+            {
+                probe.Step(options.mutation_part_, options.crossingover_part_, repetition + 1, streams, state, workspace);
+            }));
+
+    for (const auto& phase : phases)
+    {
+        stream << (is_first ? "\n" : ",\n")
+               << "    {\"phase\": \"" << phase.first << "\""
+               << ", \"population_size\": " << population_size
+               << ", \"thread_count\": " << thread_count << ", ";
+        WriteMeasurement(stream, phase.second);
+        stream << ", \"median_ns_per_individual\": "
+               << static_cast<double>(phase.second.Median()) / static_cast<double>(population_size) << "}";
+        is_first = false;
+    }
+}
+
+//! Selection keys alone, on the scored start population. The first repetition grows the arena.
+void BenchmarkSelection(
+        std::ostream& stream,
+        bool& is_first,
+        const size_t population_size,
+        const std::vector<std::string>& selection_function_names,
+        const BenchmarkOptions& options)
+{
+    const PhaseProbe probe(
+            std::make_shared<ForwardSelectionFunction<double>>(),
+            std::make_shared<RosenbrokFunctionStrategy>(population_size),
+            std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+    const GA::RandomStreams streams(options.seed_);
+    GA::State<Point2d, double> state;
+    PhaseProbe::Workspace workspace;
+    probe.Initialize(streams, state, workspace);
+
+    const auto& scores = state.current_population_score_;
+    std::vector<double> keys(population_size);
+    for (const auto& name : selection_function_names)
+    {
+        const auto& selection_function = GeneticAlgorithmSolverFactory::CreateSelectionFunction(name);
+        GA::ScratchArena arena;
+        const auto& measurement = Measure(options.repetition_count_ + 1,
+                [&](const size_t repetition)
+                {
+                    auto generator = streams.Stream(GA::RandomStreamPurpose::Selection, repetition, 0);
+                    selection_function->Selection(
+                            scores.data(), scores.size(), workspace.statistics_, generator, arena, keys.data());
+                });
+
+        stream << (is_first ? "\n" : ",\n")
+               << "    {\"selection_function\": \"" << name << "\""
+               << ", \"population_size\": " << population_size << ", ";
+        WriteMeasurement(stream, measurement);
+        stream << ", \"median_ns_per_individual\": "
+               << static_cast<double>(measurement.Median()) / static_cast<double>(population_size) << "}";
+        is_first = false;
+    }
+}
+
+void BenchmarkEndToEnd(
+        std::ostream& stream,
+        bool& is_first,
+        const size_t population_size,
+        const size_t thread_count,
+        const BenchmarkOptions& options)
+{
+    const auto& solver = GeneticAlgorithmSolverFactory::CreateStaticRosenbrokSolver(
+            "simple-forward", population_size, thread_count);
+
+    size_t iteration_count = 0;
+    const auto& measurement = Measure(options.repetition_count_,
+            [&](size_t)
+            {
+                const auto& result = solver->Calculation(
+                        options.mutation_part_, options.crossingover_part_, options.generation_count_, options.seed_);
+                iteration_count = result.iteration_count_;
+            });
+
+    stream << (is_first ? "\n" : ",\n")
+           << "    {\"population_size\": " << population_size
+           << ", \"thread_count\": " << thread_count
+           << ", \"iteration_count\": " << iteration_count << ", ";
+    WriteMeasurement(stream, measurement);
+    stream << ", \"median_ns_per_generation\": " << measurement.Median() / static_cast<long>(iteration_count) << "}";
+    is_first = false;
+}
+
+int main(int argc, char* argv[])
+{
+    po::options_description desc("Options");
+    desc.add_options()
+            ("help", "Print help messages")
+            ("population-sizes", po::value<std::string>(), "Comma separated population sizes, 1000,...,10000000 by default")
+            ("thread-counts", po::value<std::string>(), "Comma separated thread counts, 1 and all cores by default")
+            ("repetitions", po::value<size_t>(), "Measured repetitions of every case, 3 by default")
+            ("generations", po::value<size_t>(), "Generation limit of an end-to-end run, 10 by default")
+            ("mutation-part", po::value<double>(), "Mutation part, 0.3 by default")
+            ("crossingover-part", po::value<double>(), "Crossingover part, 0.2 by default")
+            ("seed", po::value<uint64_t>(), "Random seed, 42 by default")
+            ("selection-function-types", po::value<std::string>(),
+                    "Comma separated selection functions, all by default")
+            ("skip-phases", "Skip the phase cases")
+            ("skip-selection", "Skip the selection function cases")
+            ("skip-end-to-end", "Skip the end-to-end cases")
+            ("output", po::value<std::string>(), "JSON result file, standard output by default");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help"))
+        {
+            std::cout << "Genetic algorithm benchmark" << std::endl << desc << std::endl;
+            return 0;
+        }
+        po::notify(vm);
+
+        BenchmarkOptions options;
+        if (vm.count("repetitions"))
+        {
+            options.repetition_count_ = std::max<size_t>(1, vm["repetitions"].as<size_t>());
+        }
+        if (vm.count("generations"))
+        {
+            options.generation_count_ = std::max<size_t>(1, vm["generations"].as<size_t>());
+        }
+        if (vm.count("mutation-part"))
+        {
+            options.mutation_part_ = vm["mutation-part"].as<double>();
+        }
+        if (vm.count("crossingover-part"))
+        {
+            options.crossingover_part_ = vm["crossingover-part"].as<double>();
+        }
+        if (vm.count("seed"))
+        {
+            options.seed_ = vm["seed"].as<uint64_t>();
+        }
+
+        const auto& population_sizes = vm.count("population-sizes")
+                ? ParseList<size_t>(vm["population-sizes"].as<std::string>())
+                : std::vector<size_t>{1000, 10000, 100000, 1000000, 10000000};
+
+        std::vector<size_t> thread_counts = vm.count("thread-counts")
+                ? ParseList<size_t>(vm["thread-counts"].as<std::string>())
+                : std::vector<size_t>{1, std::max<size_t>(1, std::thread::hardware_concurrency())};
+        thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+        const auto& selection_function_names = vm.count("selection-function-types")
+                ? ParseList<std::string>(vm["selection-function-types"].as<std::string>())
+                : std::vector<std::string>{"simple-forward", "tournament", "linear-rank", "roulette", "stochastic-universal"};
+
+        std::ofstream file;
+        if (vm.count("output"))
+        {
+            file.open(vm["output"].as<std::string>(), std::ios::out);
+        }
+        std::ostream& stream = file.is_open() ? file : std::cout;
+
+        stream << "{\n  \"benchmark\": \"genetic_algorithm\""
+               << ",\n  \"seed\": " << options.seed_
+               << ",\n  \"repetitions\": " << options.repetition_count_
+               << ",\n  \"generations\": " << options.generation_count_
+               << ",\n  \"mutation_part\": " << options.mutation_part_
+               << ",\n  \"crossingover_part\": " << options.crossingover_part_
+               << ",\n  \"phases\": [";
+
+        bool is_first = true;
+        if (!vm.count("skip-phases"))
+        {
+            for (const size_t population_size : population_sizes)
+            {
+                for (const size_t thread_count : thread_counts)
+                {
+                    BenchmarkPhases(stream, is_first, population_size, thread_count, options);
+                }
+            }
+        }
+
+        stream << "\n  ],\n  \"selection\": [";
+
+        is_first = true;
+        if (!vm.count("skip-selection"))
+        {
+            for (const size_t population_size : population_sizes)
+            {
+                BenchmarkSelection(stream, is_first, population_size, selection_function_names, options);
+            }
+        }
+
+        stream << "\n  ],\n  \"end_to_end\": [";
+
+        is_first = true;
+        if (!vm.count("skip-end-to-end"))
+        {
+            for (const size_t population_size : population_sizes)
+            {
+                for (const size_t thread_count : thread_counts)
+                {
+                    BenchmarkEndToEnd(stream, is_first, population_size, thread_count, options);
+                }
+            }
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+    catch (const po::error& program_option)
+    {
+        std::cerr << "ERROR: " << program_option.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return -1;
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "ERROR: " << error.what() << std::endl;
+        return -2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <fstream>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+#include "../GeneticAlgorithmImpl/TrajectoryFile.h"
+
+namespace po = boost::program_options;
+
+void WriteGeneration(std::ostream& stream, const TrajectoryReader& reader, const size_t generation)
+{
+    const auto& block = reader.GetGeneration(generation);
+    for (size_t index = 0; index < reader.PopulationSize(); ++index)
+    {
+        stream << block.x_[index] << "\t" << block.y_[index] << "\t" << block.score_[index] << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    po::options_description desc("Options");
+    desc.add_options()
+            ("help", "Print help messages")
+            ("trajectory-file", po::value<std::string>()->required(), "Binary trajectory written with --dump-format binary")
+            ("generation", po::value<size_t>(), "Print one generation as text")
+            ("to-text", po::value<std::string>(), "Convert the whole trajectory to the text dump format");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help"))
+        {
+            std::cout << "Trajectory reader and converter" << std::endl << desc << std::endl;
+            return 0;
+        }
+        po::notify(vm);
+
+        const TrajectoryReader reader(vm["trajectory-file"].as<std::string>());
+
+        if (vm.count("generation"))
+        {
+            WriteGeneration(std::cout, reader, vm["generation"].as<size_t>());
+        }
+        else if (vm.count("to-text"))
+        {
+            std::ofstream stream(vm["to-text"].as<std::string>(), std::ios::out);
+            for (size_t generation = 0; generation < reader.GenerationCount(); ++generation)
+            {
+                stream << "Iteration number = " << reader.GetGeneration(generation).iteration_ << "\n";
+                WriteGeneration(stream, reader, generation);
+                stream << "\n\n";
+            }
+        }
+        else
+        {
+            std::cout << "Population size: " << reader.PopulationSize() << std::endl;
+            std::cout << "Generation count: " << reader.GenerationCount() << std::endl;
+        }
+    }
+    catch (const po::error& program_option)
+    {
+        std::cerr << "ERROR: " << program_option.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return -1;
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "ERROR: " << error.what() << std::endl;
+        return -2;
+    }
+
+    return 0;
+}
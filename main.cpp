@@ -1,10 +1,17 @@
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include <boost/program_options.hpp>
 
+#include "GeneticAlgorithm/AsyncStateSink.h"
+#include "GeneticAlgorithm/Checkpoint.h"
+#include "GeneticAlgorithm/IntervalStateSink.h"
+#include "GeneticAlgorithm/TeeStateSink.h"
 #include "GeneticAlgorithmImpl/GeneticAlgorithmSolverFactory.h"
+#include "GeneticAlgorithmImpl/SweepRunner.h"
+#include "GeneticAlgorithmImpl/TrajectoryFile.h"
 
 namespace po = boost::program_options;
 
@@ -23,77 +30,470 @@ Type check_and_get_param(const po::variables_map& vm, const std::string& field)
     return vm[field].as<Type>();
 }
 
+//! Comma separated list of a sweep option, or the single value of the plain option.
+template <typename Type>
+std::vector<Type> get_sweep_values(
+        const po::variables_map& vm,
+        const std::string& sweep_field,
+        const std::string& field)
+{
+    if (!vm.count(sweep_field))
+    {
+        return {check_and_get_param<Type>(vm, field)};
+    }
+
+    std::vector<Type> values;
+    std::istringstream stream(vm[sweep_field].as<std::string>());
+    std::string value;
+    while (std::getline(stream, value, ','))
+    {
+        values.push_back(boost::lexical_cast<Type>(value));
+    }
+    return values;
+}
 
-void WriteState(std::ofstream& stream, const GA::State<Point2d, double>& state)
+
+void WriteGenotype(std::ostream& stream, const Point2d& genotype)
+{
+    stream << genotype.x() << "\t" << genotype.y();
+}
+
+//! PointNd or PointXd, coordinates are separated by tabs.
+template <typename Point>
+void WriteGenotype(std::ostream& stream, const Point& genotype)
+{
+    for (size_t index = 0; index < genotype.Size(); ++index)
+    {
+        stream << (index == 0 ? "" : "\t") << genotype[index];
+    }
+}
+
+template <typename Genotype>
+void WriteState(std::ostream& stream, const GA::State<Genotype, double>& state)
 {
     for (size_t index = 0; index < state.current_population_score_.size(); ++index)
     {
-        stream
-                << state.current_population_[index].x() << "\t"
-                << state.current_population_[index].y() << "\t"
-                << state.current_population_score_[index] << std::endl;
+        WriteGenotype(stream, state.current_population_[index]);
+        stream << "\t" << state.current_population_score_[index] << "\n";
     }
 }
 
-void DumpProcess(
-        const std::string& basic_string,
-        const GA::GeneticAlgorithmResult<Point2d, double>& result)
+template <typename Genotype>
+class TextDumpSink final : public GA::IStateSink<Genotype, double>
 {
-    std::ofstream dump_file(basic_string, std::ios::out);
+public:
+
+    explicit TextDumpSink(std::ostream& stream)
+            : stream_(stream)
+    {}
+
+    void Consume(const size_t iteration, const GA::State<Genotype, double>& state) override
+    {
+        stream_ << "Iteration number = " << iteration << "\n";
+        WriteState(stream_, state);
+        stream_ << "\n\n";
+    }
 
+private:
+    std::ostream& stream_;
+};
+
+//! Opens the dump file, the sink writes the states when they are saved. The binary format is only for Point2d,
+//! the run summary then goes into a text file next to it, named after the dump file with ".txt" appended.
+template <typename Genotype>
+GA::IStateSinkPtr<Genotype, double> CreateDumpSink(const po::variables_map& vm, std::ofstream& dump_file)
+{
+    if (!vm.count("dump-file"))
+    {
+        return nullptr;
+    }
+
+    const auto& dump_file_name = vm["dump-file"].as<std::string>();
+    const std::string& dump_format = vm.count("dump-format")
+            ? vm["dump-format"].as<std::string>() : "text";
+    if (dump_format == "binary")
+    {
+        if constexpr (std::is_same_v<Genotype, Point2d>)
+        {
+            dump_file.open(dump_file_name + ".txt", std::ios::out);
+            return std::make_shared<GA::AsyncStateSink<Point2d, double>>(
+                    std::make_shared<BinaryTrajectorySink>(dump_file_name));
+        }
+        throw std::runtime_error("Binary dump format holds only 2 dimensional points");
+    }
+    if (dump_format != "text")
+    {
+        throw std::runtime_error("Incorrect dump format: " + dump_format);
+    }
+
+    dump_file.open(dump_file_name, std::ios::out);
+    if (vm.count("save-state"))
+    {
+        return std::make_shared<GA::AsyncStateSink<Genotype, double>>(
+                std::make_shared<TextDumpSink<Genotype>>(dump_file));
+    }
+    return nullptr;
+}
+
+template <typename Genotype>
+void DumpProcess(
+        std::ostream& dump_file,
+        const GA::GeneticAlgorithmResult<Genotype, double>& result)
+{
     if (result.times_ != std::nullopt)
     {
         dump_file << "Calculation time: " << *result.times_ << " ns." << std::endl;
     }
 
     dump_file << "Iteration count: " << result.iteration_count_ << std::endl;
+    dump_file << "Seed: " << result.seed_ << std::endl;
+}
 
-    if (!result.states_)
+void DumpIslands(
+        std::ostream& dump_file,
+        const GA::IslandGeneticAlgorithmResult<Point2d, double>& result)
+{
+    for (size_t island = 0; island < result.islands_.size(); ++island)
     {
-        return;
+        dump_file << "Island " << island << " iteration count: " << result.islands_[island].iteration_count_ << "\n";
     }
 
-    dump_file << std::endl;
+    dump_file
+            << "Best island: " << result.best_island_ << "\n"
+            << "Best individual: " << result.best_genotype_.x() << "\t" << result.best_genotype_.y()
+            << "\t" << result.best_score_ << std::endl;
+}
+
+void WriteProfile(std::ostream& stream, const GA::RunProfile& profile)
+{
+    stream << "generation";
+    for (size_t phase = 0; phase < GA::profile_phase_count; ++phase)
+    {
+        stream << "," << GA::ProfilePhaseName(static_cast<GA::ProfilePhase>(phase)) << "_ns";
+    }
+    stream << ",evaluation_count,allocation_count\n";
 
-    for (size_t index = 0; index < result.states_->size(); ++index)
+    for (size_t generation = 0; generation < profile.size(); ++generation)
     {
-        const auto& state = (*result.states_)[index];
-        dump_file << "Iteration number = " << index << std::endl;
-        WriteState(dump_file, state);
-        dump_file << std::endl << std::endl;
+        stream << generation;
+        for (const long time : profile[generation].times_)
+        {
+            stream << "," << time;
+        }
+        stream << "," << profile[generation].evaluation_count_ << "," << profile[generation].allocation_count_ << "\n";
     }
 }
 
-auto CallCalculate(
-        const bool is_dumping_process,
-        const bool is_measuring_time,
-        const double mutation_part,
-        const double crossingover_part,
-        const size_t limit,
-        const GA::GeneticAlgorithm<Point2d, double>& solver)
+//! Final population into the result file, the run summary into the dump file and the profile into its file.
+template <typename Genotype>
+void WriteResult(
+        const po::variables_map& vm,
+        const std::string& out_file_name,
+        std::ofstream& dump_file,
+        const GA::GeneticAlgorithmResult<Genotype, double>& result)
 {
-    if (is_dumping_process)
+    std::ofstream stream(out_file_name, std::ios::out);
+    WriteState(stream, result.final_state_);
+
+    if (dump_file.is_open())
+    {
+        DumpProcess(dump_file, result);
+    }
+
+    if (result.profile_)
     {
-        if (is_measuring_time)
+        std::ofstream profile_stream(vm["profile-file"].as<std::string>(), std::ios::out);
+        WriteProfile(profile_stream, *result.profile_);
+    }
+}
+
+//! Pareto front into the result file, a line is: x y objectives, the run summary into the dump file.
+void WriteParetoFront(
+        const po::variables_map& vm,
+        const std::string& out_file_name,
+        const GA::MultiObjectiveResult<Point2d, RosenbrokDistanceStrategy::ObjectivesType>& result)
+{
+    std::ofstream stream(out_file_name, std::ios::out);
+    for (const size_t index : result.pareto_front_)
+    {
+        const auto& point = result.population_[index];
+        stream << point.x() << "\t" << point.y();
+        for (const double objective : result.objectives_[index])
         {
-            return solver.Calculation<true, true>(mutation_part, crossingover_part, limit);
+            stream << "\t" << objective;
         }
-        else
+        stream << "\n";
+    }
+
+    if (vm.count("dump-file"))
+    {
+        std::ofstream dump_file(vm["dump-file"].as<std::string>(), std::ios::out);
+        if (result.times_ != std::nullopt)
         {
-            return solver.Calculation<true, false>(mutation_part, crossingover_part, limit);
+            dump_file << "Calculation time: " << *result.times_ << " ns." << std::endl;
         }
+        dump_file << "Iteration count: " << result.iteration_count_ << std::endl;
+        dump_file << "Seed: " << result.seed_ << std::endl;
+        dump_file << "Pareto front size: " << result.pareto_front_.size() << std::endl;
     }
-    else
+}
+
+//! Best individual into the result file, a line is: x y score, the whole population stays in the population file.
+void WriteOutOfCoreResult(
+        const po::variables_map& vm,
+        const std::string& out_file_name,
+        const GA::OutOfCoreResult<Point2d, double>& result)
+{
+    const auto& best = result.population_->Genotypes()[result.statistics_.best_index_];
+    std::ofstream stream(out_file_name, std::ios::out);
+    stream << best.x() << "\t" << best.y() << "\t" << result.statistics_.min_ << "\n";
+
+    if (vm.count("dump-file"))
     {
-        if (is_measuring_time)
+        std::ofstream dump_file(vm["dump-file"].as<std::string>(), std::ios::out);
+        if (result.times_ != std::nullopt)
         {
-            return solver.Calculation<false, true>(mutation_part, crossingover_part, limit);
+            dump_file << "Calculation time: " << *result.times_ << " ns." << std::endl;
         }
-        else
+        dump_file << "Iteration count: " << result.iteration_count_ << std::endl;
+        dump_file << "Seed: " << result.seed_ << std::endl;
+        dump_file
+                << "Scores: mean " << result.statistics_.mean_
+                << ", variance " << result.statistics_.variance_
+                << ", min " << result.statistics_.min_
+                << ", max " << result.statistics_.max_ << std::endl;
+    }
+}
+
+void DumpFitnessCache(std::ostream& dump_file, const GA::FitnessCacheStatistics& statistics)
+{
+    dump_file
+            << "Fitness cache hits: " << statistics.hit_count_
+            << " (from file: " << statistics.disk_hit_count_ << ")"
+            << ", misses: " << statistics.miss_count_
+            << ", hit rate: " << statistics.HitRate() << std::endl;
+}
+
+//! In-memory cache, or the cache of the file when it is given.
+Point2dFitnessCachePtr CreateFitnessCache(const po::variables_map& vm)
+{
+    if (vm.count("fitness-cache-file"))
+    {
+        return std::make_shared<Point2dFitnessCache>(vm["fitness-cache-file"].as<std::string>());
+    }
+    if (vm.count("fitness-cache"))
+    {
+        return std::make_shared<Point2dFitnessCache>();
+    }
+    return nullptr;
+}
+
+void SaveFitnessCache(const po::variables_map& vm, Point2dFitnessCache& fitness_cache)
+{
+    if (vm.count("fitness-cache-file"))
+    {
+        fitness_cache.Save();
+    }
+}
+
+//! No surrogate unless surrogate-part is given.
+SurrogateOptions CreateSurrogateOptions(const po::variables_map& vm)
+{
+    SurrogateOptions options;
+    if (vm.count("surrogate-part"))
+    {
+        const size_t neighbour_count = vm.count("surrogate-neighbours")
+                ? vm["surrogate-neighbours"].as<size_t>() : 8;
+        options.surrogate_ = std::make_shared<Point2dSurrogate>(neighbour_count);
+        options.evaluated_part_ = vm["surrogate-part"].as<double>();
+    }
+    else if (vm.count("surrogate-neighbours"))
+    {
+        throw std::runtime_error("Surrogate neighbours need surrogate-part");
+    }
+    return options;
+}
+
+void DumpSurrogate(std::ostream& dump_file, const GA::SurrogateStatistics& statistics)
+{
+    dump_file
+            << "Surrogate evaluations: " << statistics.evaluated_count_
+            << ", skipped: " << statistics.skipped_count_
+            << ", skipped part: " << statistics.SkippedPart()
+            << ", mean absolute error: " << statistics.MeanAbsoluteError() << std::endl;
+}
+
+//! No pool unless evaluator-command is given, the command is split at spaces.
+GA::EvaluatorProcessPoolPtr CreateEvaluatorPool(const po::variables_map& vm)
+{
+    if (!vm.count("evaluator-command"))
+    {
+        if (vm.count("evaluator-processes") || vm.count("evaluator-batch-size"))
         {
-            return solver.Calculation<false, false>(mutation_part, crossingover_part, limit);
+            throw std::runtime_error("Evaluator options need evaluator-command");
         }
+        return nullptr;
+    }
+
+    std::vector<std::string> command;
+    std::istringstream stream(vm["evaluator-command"].as<std::string>());
+    for (std::string argument; stream >> argument; )
+    {
+        command.push_back(argument);
+    }
+
+    const size_t process_count = vm.count("evaluator-processes")
+            ? vm["evaluator-processes"].as<size_t>() : 1;
+    const size_t batch_size = vm.count("evaluator-batch-size")
+            ? vm["evaluator-batch-size"].as<size_t>() : 256;
+    return std::make_shared<GA::EvaluatorProcessPool>(command, process_count, sizeof(Point2d), sizeof(double), batch_size);
+}
+
+void DumpEvaluatorPool(std::ostream& dump_file, const GA::EvaluatorPoolStatistics& statistics)
+{
+    dump_file
+            << "Evaluator requests: " << statistics.request_count_
+            << ", worker restarts: " << statistics.restart_count_ << std::endl;
+}
+
+GA::MigrationTopology GetMigrationTopology(const std::string& topology_name)
+{
+    if (topology_name == "ring")
+    {
+        return GA::MigrationTopology::Ring;
+    }
+    if (topology_name == "full")
+    {
+        return GA::MigrationTopology::FullyConnected;
+    }
+    throw std::runtime_error("Incorrect migration topology: " + topology_name);
+}
+
+using Point2dCheckpoint = GA::Checkpoint<Point2d, double>;
+
+//! Starts a new run, or continues the run of the checkpoint when it is given.
+template <bool IsMeasuringTime, bool IsProfiling, typename Solver>
+auto CallCalculate(
+        const double mutation_part,
+        const double crossingover_part,
+        const size_t limit,
+        const uint64_t seed,
+        const std::optional<GA::Checkpoint<typename Solver::Genotype, double>>& checkpoint,
+        const GA::IStateSinkPtr<typename Solver::Genotype, double>& sink,
+        const Solver& solver)
+{
+    if (checkpoint)
+    {
+        return solver.template Resume<false, IsMeasuringTime, IsProfiling>(*checkpoint, limit, sink);
     }
+    return solver.template Calculation<false, IsMeasuringTime, IsProfiling>(mutation_part, crossingover_part, limit, seed, sink);
+}
+
+template <bool IsProfiling, typename Solver>
+auto CallCalculate(
+        const bool is_measuring_time,
+        const double mutation_part,
+        const double crossingover_part,
+        const size_t limit,
+        const uint64_t seed,
+        const std::optional<GA::Checkpoint<typename Solver::Genotype, double>>& checkpoint,
+        const GA::IStateSinkPtr<typename Solver::Genotype, double>& sink,
+        const Solver& solver)
+{
+    if (is_measuring_time)
+    {
+        return CallCalculate<true, IsProfiling>(mutation_part, crossingover_part, limit, seed, checkpoint, sink, solver);
+    }
+    else
+    {
+        return CallCalculate<false, IsProfiling>(mutation_part, crossingover_part, limit, seed, checkpoint, sink, solver);
+    }
+}
+
+template <typename Solver>
+auto CallCalculate(
+        const bool is_measuring_time,
+        const bool is_profiling,
+        const double mutation_part,
+        const double crossingover_part,
+        const size_t limit,
+        const uint64_t seed,
+        const std::optional<GA::Checkpoint<typename Solver::Genotype, double>>& checkpoint,
+        const GA::IStateSinkPtr<typename Solver::Genotype, double>& sink,
+        const Solver& solver)
+{
+    if (is_profiling)
+    {
+        return CallCalculate<true>(is_measuring_time, mutation_part, crossingover_part, limit, seed, checkpoint, sink, solver);
+    }
+    else
+    {
+        return CallCalculate<false>(is_measuring_time, mutation_part, crossingover_part, limit, seed, checkpoint, sink, solver);
+    }
+}
+
+//! The checkpoint to continue from with --resume, none when the run hasn't written one yet.
+//! A checkpoint of a run with other parameters is an error, the random seed is taken from the checkpoint.
+std::optional<Point2dCheckpoint> ReadResumeCheckpoint(
+        const po::variables_map& vm,
+        const size_t genotype_size,
+        const double mutation_part,
+        const double crossingover_part,
+        const std::string& function_type,
+        const std::string& selection_function_type)
+{
+    const auto& checkpoint_file_name = check_and_get_param<std::string>(vm, "checkpoint-file");
+    if (!GA::IsCheckpointFile(checkpoint_file_name))
+    {
+        return std::nullopt;
+    }
+
+    auto checkpoint = GA::ReadCheckpoint<Point2d, double>(checkpoint_file_name);
+    const bool is_same_run = checkpoint.state_.current_population_.size() == genotype_size
+            && checkpoint.mutation_part_ == mutation_part
+            && checkpoint.crossingover_part_ == crossingover_part
+            && (!vm.count("seed") || checkpoint.seed_ == vm["seed"].as<uint64_t>());
+    if (!is_same_run)
+    {
+        throw std::runtime_error("Checkpoint was written by a run with other parameters: " + checkpoint_file_name);
+    }
+    if (checkpoint.function_type_ != function_type)
+    {
+        throw std::runtime_error("Checkpoint was written by a run with function type " + checkpoint.function_type_
+                + ", not " + function_type + ": " + checkpoint_file_name);
+    }
+    if (checkpoint.selection_function_type_ != selection_function_type)
+    {
+        throw std::runtime_error("Checkpoint was written by a run with selection function type "
+                + checkpoint.selection_function_type_ + ", not " + selection_function_type + ": " + checkpoint_file_name);
+    }
+    return checkpoint;
+}
+
+//! Writes every checkpoint-interval generations or checkpoint-seconds seconds, 100 generations by default.
+//! The generation is copied and written to the file on a background thread.
+GA::IStateSinkPtr<Point2d, double> CreateCheckpointSink(
+        const po::variables_map& vm,
+        const uint64_t seed,
+        const double mutation_part,
+        const double crossingover_part,
+        const std::string& function_type,
+        const std::string& selection_function_type)
+{
+    const size_t generation_interval = vm.count("checkpoint-interval")
+            ? vm["checkpoint-interval"].as<size_t>() : vm.count("checkpoint-seconds") ? 0 : 100;
+    const auto time_interval = vm.count("checkpoint-seconds")
+            ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(vm["checkpoint-seconds"].as<double>()))
+            : std::chrono::steady_clock::duration::zero();
+
+    const auto checkpoint_sink = std::make_shared<GA::CheckpointSink<Point2d, double>>(
+            vm["checkpoint-file"].as<std::string>(), seed, mutation_part, crossingover_part,
+            function_type, selection_function_type);
+    return std::make_shared<GA::IntervalStateSink<Point2d, double>>(
+            std::make_shared<GA::AsyncStateSink<Point2d, double>>(checkpoint_sink, 1),
+            generation_interval,
+            time_interval);
 }
 
 int main(int argc, char* argv[])
@@ -108,9 +508,41 @@ int main(int argc, char* argv[])
             ("max-iteration-count", po::value<size_t>()->required(), "Max iteration count")
             ("result-file", po::value<std::string>()->required(), "Result file")
             ("dump-file", po::value<std::string>(), "Dump file")
-            ("save-state", "Save state")
+            ("dump-format", po::value<std::string>(), "Dump format: text (default) or binary, binary always saves states")
+            ("save-state", "Stream every generation into the dump file")
             ("measuring-time", "Measuring time")
-            ("selection-function-type", po::value<std::string>(), "Selection function type: simple-forward");
+            ("profile-file", po::value<std::string>(), "CSV file with the phase times, evaluations and allocations of every generation, allocations are counted in builds with GA_COUNT_ALLOCATIONS")
+            ("selection-function-type", po::value<std::string>(), "Selection function type: simple-forward, tournament, linear-rank, roulette or stochastic-universal")
+            ("threads", po::value<size_t>(), "Fitness evaluation thread count, 1 by default; in a sweep, job thread count, all cores by default")
+            ("dimension", po::value<size_t>(), "Coordinates of a point, 2 by default, other dimensions work with the single population solver")
+            ("seed", po::value<uint64_t>(), "Random seed, the same seed gives the same result at any thread count")
+            ("static-dispatch", "Bind strategy and selection function at compile time (rosenbrok, simple-forward)")
+            ("multi-objective", "NSGA-II engine, minimizes the function and the squared distance to the origin together, the result file holds the Pareto front")
+            ("steady-state", "Asynchronous steady state engine, children replace the worst individuals as soon as they are scored, max-iteration-count counts epochs of genotype-size children")
+            ("population-file", po::value<std::string>(), "Keep the population in this memory mapped file instead of memory, for populations larger than memory; the result file holds the best individual")
+            ("population-file-overwrite", "Replace an existing population file, without it an existing file is an error")
+            ("population-block-size", po::value<size_t>(), "Individuals of the population file processed together, 1048576 by default")
+            ("islands", po::value<size_t>(), "Island count, each island has genotype-size individuals, 1 by default")
+            ("migration-interval", po::value<size_t>(), "Generations between migrations, 10 by default")
+            ("migrant-count", po::value<size_t>(), "Individuals sent to each neighbour island, 1 by default")
+            ("migration-topology", po::value<std::string>(), "Migration topology: ring (default) or full")
+            ("processes", po::value<size_t>(), "Run one island per worker process, migrants go through shared memory")
+            ("fitness-cache", "Look fitness values up in an in-memory cache before evaluating them")
+            ("fitness-cache-file", po::value<std::string>(), "Fitness cache file, read at start and updated at the end, implies --fitness-cache")
+            ("surrogate-part", po::value<double>(), "Part of the children scored by the fitness function, a k-NN model of the evaluated genotypes predicts the others and picks the ones to score")
+            ("surrogate-neighbours", po::value<size_t>(), "Neighbours of a surrogate prediction, 8 by default")
+            ("evaluator-command", po::value<std::string>(), "Score genotypes in worker processes started with this command, for example: evaluator_worker --delay-microseconds 1000")
+            ("evaluator-processes", po::value<size_t>(), "Evaluator worker processes, 1 by default")
+            ("evaluator-batch-size", po::value<size_t>(), "Genotypes in one request to an evaluator worker, 256 by default")
+            ("checkpoint-file", po::value<std::string>(), "Checkpoint file, keeps the last checkpoint of the run")
+            ("checkpoint-interval", po::value<size_t>(), "Generations between checkpoints, 100 by default")
+            ("checkpoint-seconds", po::value<double>(), "Seconds between checkpoints, with checkpoint-interval the first one reached counts")
+            ("resume", "Continue the run from the checkpoint file, start it when there is no checkpoint yet")
+            ("sweep-file", po::value<std::string>(), "Sweep jobs file, a line is: mutation-part crossingover-part genotype-size [seed]")
+            ("sweep-mutation-parts", po::value<std::string>(), "Sweep grid values of mutation-part, comma separated")
+            ("sweep-crossingover-parts", po::value<std::string>(), "Sweep grid values of crossingover-part, comma separated")
+            ("sweep-genotype-sizes", po::value<std::string>(), "Sweep grid values of genotype-size, comma separated")
+            ("sweep-repeats", po::value<size_t>(), "Runs of every sweep grid point with different seeds, 1 by default");
 
     po::variables_map vm;
     try
@@ -124,6 +556,90 @@ int main(int argc, char* argv[])
 
         const auto& function_type = check_and_get_param<std::string>(vm, "function-type");
         const auto& out_file_name = check_and_get_param<std::string>(vm, "result-file");
+
+        const bool is_sweep = vm.count("sweep-file") || vm.count("sweep-mutation-parts")
+                || vm.count("sweep-crossingover-parts") || vm.count("sweep-genotype-sizes");
+        if (is_sweep)
+        {
+            if (vm.count("checkpoint-file") || vm.count("resume"))
+            {
+                throw std::runtime_error("Sweep doesn't checkpoint");
+            }
+            if (vm.count("surrogate-part"))
+            {
+                throw std::runtime_error("Sweep doesn't pre-screen children");
+            }
+            if (vm.count("evaluator-command"))
+            {
+                throw std::runtime_error("Sweep doesn't use evaluator workers");
+            }
+            if (vm.count("islands") || vm.count("processes") || vm.count("migration-interval")
+                    || vm.count("migrant-count") || vm.count("migration-topology"))
+            {
+                throw std::runtime_error("Sweep runs a single population in every job");
+            }
+            if (vm.count("static-dispatch"))
+            {
+                throw std::runtime_error("Sweep has no static dispatch");
+            }
+            if (vm.count("profile-file") || vm.count("save-state") || vm.count("dump-format"))
+            {
+                throw std::runtime_error("Sweep writes only the result table and the fitness cache statistics");
+            }
+            if (vm.count("steady-state"))
+            {
+                throw std::runtime_error("Sweep runs the generational engine");
+            }
+            if (vm.count("dimension") && vm["dimension"].as<size_t>() != 2)
+            {
+                throw std::runtime_error("Sweep works only with 2 dimensional points");
+            }
+            if (vm.count("multi-objective"))
+            {
+                throw std::runtime_error("Sweep is single-objective");
+            }
+            if (vm.count("population-file") || vm.count("population-file-overwrite") || vm.count("population-block-size"))
+            {
+                throw std::runtime_error("Sweep keeps its populations in memory");
+            }
+
+            const std::string& selection_function_type = vm.count("selection-function-type")
+                    ? vm["selection-function-type"].as<std::string>() : "";
+            const size_t limit = vm.count("max-iteration-count")
+                    ? vm["max-iteration-count"].as<size_t>() : 1000;
+            const size_t thread_count = vm.count("threads")
+                    ? vm["threads"].as<size_t>() : std::max(1u, std::thread::hardware_concurrency());
+            const uint64_t seed = vm.count("seed")
+                    ? vm["seed"].as<uint64_t>() : std::random_device{}();
+
+            const auto& jobs = vm.count("sweep-file")
+                    ? ReadSweepJobs(vm["sweep-file"].as<std::string>(), seed)
+                    : MakeSweepGrid(
+                            get_sweep_values<double>(vm, "sweep-mutation-parts", "mutation-part"),
+                            get_sweep_values<double>(vm, "sweep-crossingover-parts", "crossingover-part"),
+                            get_sweep_values<size_t>(vm, "sweep-genotype-sizes", "genotype-size"),
+                            vm.count("sweep-repeats") ? vm["sweep-repeats"].as<size_t>() : 1,
+                            seed);
+
+            const auto fitness_cache = CreateFitnessCache(vm);
+            const auto& results = RunSweep(
+                    jobs, function_type, selection_function_type, limit, thread_count, fitness_cache);
+
+            std::ofstream stream(out_file_name, std::ios::out);
+            WriteSweepResults(stream, results);
+
+            if (fitness_cache)
+            {
+                SaveFitnessCache(vm, *fitness_cache);
+                if (vm.count("dump-file"))
+                {
+                    std::ofstream dump_file(vm["dump-file"].as<std::string>(), std::ios::out);
+                    DumpFitnessCache(dump_file, fitness_cache->Statistics());
+                }
+            }
+            return 0;
+        }
+
         const size_t genotype_size = check_and_get_param<size_t>(vm, "genotype-size");
         const double mutation_part = check_and_get_param<double>(vm, "mutation-part");
         const double crossingover_part = check_and_get_param<double>(vm, "crossingover-part");
@@ -134,28 +650,317 @@ int main(int argc, char* argv[])
         const size_t limit = vm.count("max-iteration-count")
                 ? vm["max-iteration-count"].as<size_t>() : 1000;
 
-        const auto solver = GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
-                function_type,
-                selection_function_type,
-                genotype_size);
+        const size_t thread_count = vm.count("threads")
+                ? vm["threads"].as<size_t>() : 1;
+
+        const bool is_measuring_time = static_cast<const bool>(vm.count("measuring-time"));
+        const bool is_profiling = vm.count("profile-file") != 0;
 
-        if (!solver)
+        if (vm.count("multi-objective"))
         {
-            throw std::runtime_error("Empty solver");
+            const bool is_single_objective_option = vm.count("islands") || vm.count("processes")
+                    || vm.count("static-dispatch") || vm.count("steady-state") || vm.count("dimension")
+                    || vm.count("fitness-cache") || vm.count("fitness-cache-file") || vm.count("surrogate-part")
+                    || vm.count("evaluator-command") || vm.count("checkpoint-file") || vm.count("resume")
+                    || vm.count("save-state") || vm.count("dump-format") || vm.count("population-file") || is_profiling;
+            if (is_single_objective_option)
+            {
+                throw std::runtime_error("Multi-objective engine runs a single population of 2 dimensional points");
+            }
+            if (!selection_function_type.empty() && selection_function_type != "tournament")
+            {
+                throw std::runtime_error("Multi-objective engine selects parents by crowded tournament");
+            }
+
+            const uint64_t seed = vm.count("seed")
+                    ? vm["seed"].as<uint64_t>() : std::random_device{}();
+            const auto& solver = GeneticAlgorithmSolverFactory::CreateMultiObjectivePoint2dSolver(
+                    function_type, genotype_size, thread_count);
+            const auto& result = is_measuring_time
+                    ? solver->Calculation<true>(mutation_part, crossingover_part, limit, seed)
+                    : solver->Calculation<false>(mutation_part, crossingover_part, limit, seed);
+            WriteParetoFront(vm, out_file_name, result);
+            return 0;
         }
 
-        const bool is_measuring_time = static_cast<const bool>(vm.count("measuring-time"));
-        const bool is_save_state = static_cast<const bool>(vm.count("save_state"));
+        const size_t dimension = vm.count("dimension")
+                ? vm["dimension"].as<size_t>() : 2;
+        if (dimension != 2)
+        {
+            const bool is_point2d_option = vm.count("islands") || vm.count("processes") || vm.count("static-dispatch")
+                    || vm.count("steady-state") || vm.count("fitness-cache") || vm.count("fitness-cache-file")
+                    || vm.count("surrogate-part") || vm.count("evaluator-command")
+                    || vm.count("checkpoint-file") || vm.count("resume") || vm.count("population-file");
+            if (is_point2d_option)
+            {
+                throw std::runtime_error("Dimension other than 2 works only with the single population solver");
+            }
+
+            const uint64_t seed = vm.count("seed")
+                    ? vm["seed"].as<uint64_t>() : std::random_device{}();
+
+            GeneticAlgorithmSolverFactory::WithPointNdSolver(
+                    function_type, selection_function_type, genotype_size, dimension, thread_count,
+                    [&](const auto& solver)
+                    {
+                        using Genotype = typename std::decay_t<decltype(solver)>::Genotype;
+
+                        std::ofstream dump_file;
+                        const auto& sink = CreateDumpSink<Genotype>(vm, dump_file);
+                        const auto& result = CallCalculate(
+                                is_measuring_time, is_profiling, mutation_part, crossingover_part, limit, seed,
+                                std::nullopt, sink, solver);
+                        WriteResult(vm, out_file_name, dump_file, result);
+                    });
+            return 0;
+        }
+
+        if (vm.count("population-file"))
+        {
+            const bool is_in_memory_option = vm.count("islands") || vm.count("processes")
+                    || vm.count("static-dispatch") || vm.count("steady-state")
+                    || vm.count("fitness-cache") || vm.count("fitness-cache-file") || vm.count("surrogate-part")
+                    || vm.count("checkpoint-file") || vm.count("resume")
+                    || vm.count("save-state") || vm.count("dump-format") || is_profiling;
+            if (is_in_memory_option)
+            {
+                throw std::runtime_error("Population file works only with a single population of 2 dimensional points");
+            }
+            if (!selection_function_type.empty() && selection_function_type != "simple-forward")
+            {
+                throw std::runtime_error("Population file engine replaces the worst individuals of every block");
+            }
+
+            const uint64_t seed = vm.count("seed")
+                    ? vm["seed"].as<uint64_t>() : std::random_device{}();
+            const size_t block_size = vm.count("population-block-size")
+                    ? vm["population-block-size"].as<size_t>() : size_t{1} << 20;
+
+            const auto evaluator_pool = CreateEvaluatorPool(vm);
+            const auto& solver = GeneticAlgorithmSolverFactory::CreateOutOfCorePoint2dSolver(
+                    function_type, genotype_size, thread_count, block_size, evaluator_pool);
+            const auto population = std::make_shared<MappedPoint2dPopulation>(
+                    vm["population-file"].as<std::string>(), genotype_size, vm.count("population-file-overwrite") != 0);
+            const auto& result = is_measuring_time
+                    ? solver->Calculation<true>(population, mutation_part, crossingover_part, limit, seed)
+                    : solver->Calculation<false>(population, mutation_part, crossingover_part, limit, seed);
+            population->Flush();
+            WriteOutOfCoreResult(vm, out_file_name, result);
+            if (evaluator_pool && vm.count("dump-file"))
+            {
+                std::ofstream dump_file(vm["dump-file"].as<std::string>(), std::ios::app);
+                DumpEvaluatorPool(dump_file, evaluator_pool->Statistics());
+            }
+            return 0;
+        }
+
+        std::ofstream dump_file;
+        GA::IStateSinkPtr<Point2d, double> sink = CreateDumpSink<Point2d>(vm, dump_file);
+
+        const auto checkpoint = vm.count("resume")
+                ? ReadResumeCheckpoint(vm, genotype_size, mutation_part, crossingover_part, function_type, selection_function_type)
+                : std::nullopt;
+
+        const uint64_t seed = checkpoint ? checkpoint->seed_
+                : vm.count("seed") ? vm["seed"].as<uint64_t>() : std::random_device{}();
+
+        const size_t island_count = vm.count("islands")
+                ? vm["islands"].as<size_t>() : 1;
+
+        const size_t process_count = vm.count("processes")
+                ? vm["processes"].as<size_t>() : 1;
+
+        const auto fitness_cache = CreateFitnessCache(vm);
+        if (fitness_cache && (island_count > 1 || process_count > 1 || vm.count("static-dispatch")))
+        {
+            throw std::runtime_error("Fitness cache works only with the dynamic single population solver");
+        }
+
+        const auto surrogate_options = CreateSurrogateOptions(vm);
+        if (surrogate_options.surrogate_ && (island_count > 1 || process_count > 1 || vm.count("static-dispatch")))
+        {
+            throw std::runtime_error("Surrogate works only with the dynamic single population solver");
+        }
+
+        const auto evaluator_pool = CreateEvaluatorPool(vm);
+        if (evaluator_pool && (island_count > 1 || process_count > 1 || vm.count("static-dispatch")))
+        {
+            throw std::runtime_error("Evaluator workers work only with the dynamic single population solver");
+        }
+
+        const bool is_island_model = island_count > 1 || process_count > 1;
+        if (vm.count("checkpoint-file"))
+        {
+            if (is_island_model)
+            {
+                throw std::runtime_error("Island model doesn't checkpoint");
+            }
+            if (vm.count("steady-state"))
+            {
+                throw std::runtime_error("Steady state engine doesn't checkpoint");
+            }
+            if (surrogate_options.surrogate_)
+            {
+                throw std::runtime_error("Surrogate model isn't checkpointed");
+            }
+
+            const auto checkpoint_sink = CreateCheckpointSink(
+                    vm, seed, mutation_part, crossingover_part, function_type, selection_function_type);
+            sink = sink
+                    ? std::make_shared<GA::TeeStateSink<Point2d, double>>(
+                            std::vector<GA::IStateSinkPtr<Point2d, double>>{sink, checkpoint_sink})
+                    : checkpoint_sink;
+        }
+
+        GA::GeneticAlgorithmResult<Point2d, double> result;
+        if (is_island_model)
+        {
+            if (sink)
+            {
+                throw std::runtime_error("Island model doesn't save states");
+            }
+            if (is_profiling)
+            {
+                throw std::runtime_error("Island model doesn't profile generations");
+            }
+            if (island_count > 1 && process_count > 1)
+            {
+                throw std::runtime_error("Use either islands or processes");
+            }
+            if (vm.count("static-dispatch"))
+            {
+                throw std::runtime_error("Island model has no static dispatch");
+            }
+
+            GA::MigrationOptions migration_options;
+            if (vm.count("migration-interval"))
+            {
+                migration_options.interval_ = vm["migration-interval"].as<size_t>();
+            }
+            if (vm.count("migrant-count"))
+            {
+                migration_options.migrant_count_ = vm["migrant-count"].as<size_t>();
+            }
+            if (vm.count("migration-topology"))
+            {
+                migration_options.topology_ = GetMigrationTopology(vm["migration-topology"].as<std::string>());
+            }
+
+            GA::IslandGeneticAlgorithmResult<Point2d, double> island_result;
+            if (process_count > 1)
+            {
+                const auto solver = GeneticAlgorithmSolverFactory::CreateProcessIslandPoint2dSolver(
+                        function_type,
+                        selection_function_type,
+                        genotype_size,
+                        process_count,
+                        migration_options,
+                        thread_count);
+
+                island_result = solver->Calculation(mutation_part, crossingover_part, limit, seed);
+            }
+            else
+            {
+                const auto solver = GeneticAlgorithmSolverFactory::CreateIslandPoint2dSolver(
+                        function_type,
+                        selection_function_type,
+                        genotype_size,
+                        island_count,
+                        migration_options,
+                        thread_count);
+
+                island_result = solver->Calculation(mutation_part, crossingover_part, limit, seed);
+            }
+            result = island_result.islands_[island_result.best_island_];
+            result.seed_ = seed;
+
+            if (dump_file.is_open())
+            {
+                DumpIslands(dump_file, island_result);
+            }
+        }
+        else if (vm.count("steady-state"))
+        {
+            if (vm.count("static-dispatch"))
+            {
+                throw std::runtime_error("Steady state engine has no static dispatch");
+            }
+            if (is_profiling)
+            {
+                throw std::runtime_error("Steady state engine doesn't profile generations");
+            }
+            if (!selection_function_type.empty() && selection_function_type != "tournament")
+            {
+                throw std::runtime_error("Steady state engine selects parents by tournament");
+            }
+            if (surrogate_options.surrogate_)
+            {
+                throw std::runtime_error("Steady state engine scores one child at a time, there is nothing to pre-screen");
+            }
 
-        const auto& result =
-                CallCalculate(is_save_state, is_measuring_time, mutation_part, crossingover_part, limit, *solver);
+            const auto solver = GeneticAlgorithmSolverFactory::CreateSteadyStatePoint2dSolver(
+                    function_type,
+                    genotype_size,
+                    thread_count,
+                    fitness_cache,
+                    evaluator_pool);
 
-        std::ofstream stream(out_file_name, std::ios::out);
-        WriteState(stream, result.final_state_);
+            result = is_measuring_time
+                    ? solver->Calculation<false, true>(mutation_part, crossingover_part, limit, seed, sink)
+                    : solver->Calculation<false, false>(mutation_part, crossingover_part, limit, seed, sink);
+        }
+        else if (vm.count("static-dispatch"))
+        {
+            if (function_type != "rosenbrok")
+            {
+                throw std::runtime_error("Static dispatch supports only rosenbrok function");
+            }
+
+            const auto solver = GeneticAlgorithmSolverFactory::CreateStaticRosenbrokSolver(
+                    selection_function_type,
+                    genotype_size,
+                    thread_count);
+
+            result = CallCalculate(
+                    is_measuring_time, is_profiling, mutation_part, crossingover_part, limit, seed, checkpoint, sink, *solver);
+        }
+        else
+        {
+            const auto solver = GeneticAlgorithmSolverFactory::CreateGeneticAlgorithmPoint2dSolver(
+                    function_type,
+                    selection_function_type,
+                    genotype_size,
+                    thread_count,
+                    fitness_cache,
+                    surrogate_options,
+                    evaluator_pool);
+
+            if (!solver)
+            {
+                throw std::runtime_error("Empty solver");
+            }
 
-        if (vm.count("dump-file"))
+            result = CallCalculate(
+                    is_measuring_time, is_profiling, mutation_part, crossingover_part, limit, seed, checkpoint, sink, *solver);
+        }
+
+        WriteResult(vm, out_file_name, dump_file, result);
+
+        if (fitness_cache)
+        {
+            SaveFitnessCache(vm, *fitness_cache);
+            if (dump_file.is_open())
+            {
+                DumpFitnessCache(dump_file, fitness_cache->Statistics());
+            }
+        }
+        if (surrogate_options.surrogate_ && dump_file.is_open())
+        {
+            DumpSurrogate(dump_file, surrogate_options.surrogate_->Statistics());
+        }
+        if (evaluator_pool && dump_file.is_open())
         {
-            DumpProcess(vm["dump-file"].as<std::string>(), result);
+            DumpEvaluatorPool(dump_file, evaluator_pool->Statistics());
         }
     }
     catch (const po::error& program_option)